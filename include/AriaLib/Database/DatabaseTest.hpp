@@ -37,21 +37,27 @@ namespace aria
 			, TestTimes const & times );
 		AriaLib_API void createNewRun( wxFileName const & match
 			, TestTimes const & times );
+		// Same as createNewRun, but the run insertion waits for TestDatabase::flushRuns.
+		AriaLib_API void queueNewRun( TestStatus status
+			, db::DateTime const & runDate
+			, TestTimes const & times );
+		AriaLib_API void queueNewRun( wxFileName const & match
+			, TestTimes const & times );
 		AriaLib_API void changeCategory( Category dstCategory
 			, TestsCounts & dstCounts );
 		AriaLib_API std::string getPrefixedName( uint32_t index )const;
 		AriaLib_API std::string getUnprefixedName()const;
 		AriaLib_API bool hasNumPrefix()const;
+		// To be called when the engine or scene file dates have changed.
+		AriaLib_API void updateOutOfDate( bool remove = true )const;
 
 		bool checkOutOfEngineDate()const
 		{
-			updateOutOfDate();
 			return m_outOfEngineDate;
 		}
 
 		bool checkOutOfTestDate()const
 		{
-			updateOutOfDate();
 			return m_outOfTestDate;
 		}
 
@@ -129,7 +135,9 @@ namespace aria
 			, db::DateTime testDate
 			, TestTimes times );
 		void updateReference( TestStatus status );
-		AriaLib_API void updateOutOfDate( bool remove = true )const;
+		void doUpdateNewRun( TestStatus status
+			, db::DateTime const & runDate
+			, TestTimes const & times );
 
 	private:
 		TestDatabase * m_database;
@@ -143,7 +151,8 @@ namespace aria
 	class RendererTestRuns
 	{
 	private:
-		using Cont = std::vector< DatabaseTest >;
+		// A list, since the tree nodes keep pointers to the tests, and categories are loaded on demand.
+		using Cont = std::list< DatabaseTest >;
 
 	public:
 		AriaLib_API RendererTestRuns( RendererTestRuns const & ) = delete;
@@ -15,9 +15,17 @@ namespace aria::db
 	class Connection
 	{
 	public:
-		explicit Connection( wxFileName databaseFile );
+		explicit Connection( wxFileName databaseFile
+			, ConnectionOptions const & options = ConnectionOptions{}
+			, bool readOnly = false );
 		~Connection();
 
+		void configure( ConnectionOptions const & options );
+		bool setJournalMode( JournalMode mode );
+		// Writes the whole WAL back to the database file, returns false if it couldn't be done completely.
+		bool checkpoint();
+		bool isInTransaction()const;
+
 		bool executeUpdate( sqlite3_stmt * statement );
 		ResultPtr executeSelect( sqlite3_stmt * statement, ValuedObjectInfosArray & infos );
 		Transaction beginTransaction( std::string const & name );
@@ -51,8 +59,19 @@ namespace aria::db
 			return m_database;
 		}
 
+		bool isReadOnly() const
+		{
+			return m_readOnly;
+		}
+
+		int64_t getLastInsertId() const
+		{
+			return sqlite3_last_insert_rowid( m_database );
+		}
+
 	private:
 		sqlite3 * m_database{};
+		bool m_readOnly{};
 	};
 }
 
@@ -0,0 +1,93 @@
+/*
+See LICENSE file in root folder
+*/
+#ifndef ___Aria_DbCursor_HPP___
+#define ___Aria_DbCursor_HPP___
+
+#include "DbPrerequisites.hpp"
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <sqlite3.h>
+
+#include <string_view>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria::db
+{
+	// Streams the rows of a Statement, reading the columns directly from the live SQLite statement.
+	// Text values are only valid until the next call to next().
+	class Cursor
+	{
+		friend class Statement;
+
+	public:
+		Cursor( Cursor const & ) = delete;
+		Cursor & operator=( Cursor const & ) = delete;
+		Cursor( Cursor && rhs )noexcept;
+		Cursor & operator=( Cursor && rhs ) = delete;
+		~Cursor();
+
+		bool next();
+
+		bool isNull( int index )const;
+		int32_t getInt32( int index )const;
+		int64_t getInt64( int index )const;
+		double getDouble( int index )const;
+		std::string_view getText( int index )const;
+		DateTime getDateTime( int index )const;
+
+		template< typename T >
+		T get( int index )const;
+
+		bool isValid()const
+		{
+			return m_valid;
+		}
+
+		explicit operator bool()const
+		{
+			return m_valid;
+		}
+
+	private:
+		Cursor( Connection & connection
+			, sqlite3_stmt * statement );
+
+	private:
+		Connection * m_connection;
+		sqlite3_stmt * m_statement;
+		bool m_valid{ true };
+	};
+
+	template<>
+	inline int32_t Cursor::get< int32_t >( int index )const
+	{
+		return getInt32( index );
+	}
+
+	template<>
+	inline int64_t Cursor::get< int64_t >( int index )const
+	{
+		return getInt64( index );
+	}
+
+	template<>
+	inline double Cursor::get< double >( int index )const
+	{
+		return getDouble( index );
+	}
+
+	template<>
+	inline std::string Cursor::get< std::string >( int index )const
+	{
+		return std::string{ getText( index ) };
+	}
+
+	template<>
+	inline DateTime Cursor::get< DateTime >( int index )const
+	{
+		return getDateTime( index );
+	}
+}
+
+#endif
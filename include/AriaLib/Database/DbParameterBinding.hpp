@@ -328,13 +328,13 @@ namespace aria::db
 			}
 			else
 			{
-				m_holder = m_value.getValue().FormatISODate() + " " + m_value.getValue().FormatISOTime();
-				sqliteCheck( sqlite3_bind_text( statement, index, m_holder.c_str(), int( m_holder.size() ), SQLITE_STATIC ), std::stringstream{} << INFO_SQLITE_SET_PARAMETER_VALUE << m_holder, connection );
+				// Dates are stored as seconds since epoch.
+				auto ticks = sqlite3_int64( m_value.getValue().GetTicks() );
+				sqliteCheck( sqlite3_bind_int64( statement, index, ticks ), std::stringstream{} << INFO_SQLITE_SET_PARAMETER_VALUE << ticks, connection );
 			}
 		}
 
 		ValueT< FieldType::eDatetime > const & m_value;
-		std::string m_holder;
 	};
 
 	template<>
@@ -75,6 +75,37 @@ namespace aria::db
 	using ParameterArray = std::vector< ParameterPtr >;
 	using ValuedObjectInfosArray = std::vector< ValuedObjectInfos >;
 	using RowArray = std::vector< Row >;
+
+	enum class JournalMode
+	{
+		eDelete,
+		eWal,
+	};
+
+	enum class Synchronous
+	{
+		eOff,
+		eNormal,
+		eFull,
+	};
+
+	enum class TempStore
+	{
+		eDefault,
+		eFile,
+		eMemory,
+	};
+
+	struct ConnectionOptions
+	{
+		JournalMode journalMode{ JournalMode::eWal };
+		Synchronous synchronous{ Synchronous::eNormal };
+		// PRAGMA mmap_size, in bytes.
+		int64_t mmapSize{ 256ll * 1024ll * 1024ll };
+		// PRAGMA cache_size, in pages when positive, in KiB when negative.
+		int64_t cacheSize{ -64ll * 1024ll };
+		TempStore tempStore{ TempStore::eMemory };
+	};
 }
 
 #pragma warning( pop )
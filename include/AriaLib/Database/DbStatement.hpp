@@ -4,6 +4,7 @@ See LICENSE file in root folder
 #ifndef ___Aria_DbStatement_HPP___
 #define ___Aria_DbStatement_HPP___
 
+#include "DbCursor.hpp"
 #include "DbParameteredObject.hpp"
 
 namespace aria::db
@@ -17,6 +18,7 @@ namespace aria::db
 
 		bool executeUpdate();
 		ResultPtr executeSelect();
+		Cursor executeCursor();
 
 		Parameter * createParameter( const std::string & name
 			, FieldType fieldType
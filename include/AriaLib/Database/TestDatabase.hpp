@@ -9,12 +9,13 @@ See LICENSE file in root folder
 #include "DbStatement.hpp"
 
 #include "AriaLib/BeginExternHeaderGuard.hpp"
+#include <atomic>
 #include <list>
 #include <map>
+#include <mutex>
+#include <span>
 #include "AriaLib/EndExternHeaderGuard.hpp"
 
-class wxProgressDialog;
-
 namespace aria
 {
 	class TestDatabase
@@ -26,10 +27,21 @@ namespace aria
 			, FileSystem & fileSystem );
 		AriaLib_API ~TestDatabase();
 
-		AriaLib_API void initialise( wxProgressDialog & progress
+		AriaLib_API void initialise( Progress & progress
 			, int & index );
 
+		// The transaction must be begun and ended under lockWriter().
 		AriaLib_API db::Transaction beginTransaction( std::string const & name );
+		// Serialises the writes to the database connection, across threads.
+		// The writing functions take it, the transactions spanning several of them must hold it from begin to end.
+		AriaLib_API std::unique_lock< std::recursive_mutex > lockWriter();
+		// Inserts the runs within one transaction, their IDs are updated.
+		AriaLib_API void insertRuns( std::span< TestRun * const > runs
+			, bool moveFiles = true );
+		// Inserts the runs queued by DatabaseTest::queueNewRun, within one transaction.
+		// To be called on the thread queuing the runs, before any other update of their tests.
+		AriaLib_API void flushRuns();
+		AriaLib_API bool isRunQueued( DatabaseTest const & test );
 
 		AriaLib_API void moveResultFile( DatabaseTest const & test
 			, TestStatus oldStatus
@@ -51,11 +63,11 @@ namespace aria
 		AriaLib_API Keyword createKeyword( std::string const & name );
 
 		AriaLib_API TestMap listTests();
-		AriaLib_API TestMap listTests( wxProgressDialog & progress
+		AriaLib_API TestMap listTests( Progress & progress
 			, int & index );
 		AriaLib_API void listTests( TestMap & result );
 		AriaLib_API void listTests( TestMap & result
-			, wxProgressDialog & progress
+			, Progress & progress
 			, int & index );
 		AriaLib_API void deleteTest( uint32_t testId );
 		AriaLib_API void updateTestName( Test const & test
@@ -65,13 +77,13 @@ namespace aria
 
 		AriaLib_API AllTestRuns listLatestRuns( TestMap const & tests );
 		AriaLib_API AllTestRuns listLatestRuns( TestMap const & tests
-			, wxProgressDialog & progress
+			, Progress & progress
 			, int & index );
 		AriaLib_API void listLatestRuns( TestMap const & tests
 			, AllTestRuns & result );
 		AriaLib_API void listLatestRuns( TestMap const & tests
 			, AllTestRuns & result
-			, wxProgressDialog & progress
+			, Progress & progress
 			, int & index );
 		AriaLib_API void listLatestRuns( Renderer renderer
 			, TestMap const & tests
@@ -79,8 +91,17 @@ namespace aria
 		AriaLib_API void listLatestRuns( Renderer renderer
 			, TestMap const & tests
 			, RendererTestRuns & result
-			, wxProgressDialog & progress
+			, Progress & progress
 			, int & index );
+		// Appends the latest runs of the category tests, and returns them.
+		AriaLib_API DatabaseTestArray listLatestRuns( Renderer renderer
+			, Category category
+			, TestArray const & tests
+			, RendererTestRuns & result );
+		// Fills the categories counts from the latest runs statuses, without loading the runs.
+		AriaLib_API void countLatestRuns( Renderer renderer
+			, TestMap const & tests
+			, RendererTestsCounts & result );
 		AriaLib_API RunMap listRuns( int testId );
 		AriaLib_API void deleteRun( uint32_t runId );
 		AriaLib_API void updateRunHost( uint32_t runId, int32_t hostId );
@@ -98,6 +119,8 @@ namespace aria
 		AriaLib_API Host * getHost( std::string const & platform
 			, std::string const & cpu
 			, std::string const & gpu );
+		// Reads the times file written by a test run, and removes it.
+		AriaLib_API TestTimes processTestOutputTimes( wxFileName const & timesFilePath );
 
 		RendererMap const & getRenderers()const
 		{
@@ -361,30 +384,19 @@ namespace aria
 		{
 			InsertRunV2() = default;
 			explicit InsertRunV2( db::Connection & connection )
-				: stmt{ connection.createStatement( "INSERT INTO TestRun (TestId, RendererId, RunDate, Status, EngineDate, SceneDate) VALUES (?, ?, ?, ?, ?, ?);" ) }
-				, select{ connection.createStatement( "SELECT Id FROM TestRun WHERE TestId=? AND RendererId=? AND RunDate=? AND Status=? AND EngineDate=? AND SceneDate=?;" ) }
+				: connection{ &connection }
+				, stmt{ connection.createStatement( "INSERT INTO TestRun (TestId, RendererId, RunDate, Status, EngineDate, SceneDate) VALUES (?, ?, ?, ?, ?, ?);" ) }
 				, testId{ stmt->createParameter( "TestId", db::FieldType::eSint32 ) }
-				, sTestId{ select->createParameter( "TestId", db::FieldType::eSint32 ) }
 				, rendererId{ stmt->createParameter( "RendererId", db::FieldType::eSint32 ) }
-				, sRendererId{ select->createParameter( "RendererId", db::FieldType::eSint32 ) }
 				, runDate{ stmt->createParameter( "RunDate", db::FieldType::eDatetime ) }
-				, sRunDate{ select->createParameter( "RunDate", db::FieldType::eDatetime ) }
 				, status{ stmt->createParameter( "Status", db::FieldType::eSint32 ) }
-				, sStatus{ select->createParameter( "Status", db::FieldType::eSint32 ) }
 				, engineDate{ stmt->createParameter( "EngineDate", db::FieldType::eDatetime ) }
-				, sEngineDate{ select->createParameter( "EngineDate", db::FieldType::eDatetime ) }
 				, testDate{ stmt->createParameter( "SceneDate", db::FieldType::eDatetime ) }
-				, sTestDate{ select->createParameter( "SceneDate", db::FieldType::eDatetime ) }
 			{
 				if ( !stmt->initialise() )
 				{
 					throw std::runtime_error{ "Couldn't create InsertRun INSERT statement." };
 				}
-
-				if ( !select->initialise() )
-				{
-					throw std::runtime_error{ "Couldn't create InsertRun SELECT statement." };
-				}
 			}
 
 			int32_t insert( int32_t id
@@ -395,58 +407,37 @@ namespace aria
 				, db::DateTime const & dateScene );
 
 		private:
+			db::Connection * connection{};
 			db::StatementPtr stmt;
-			db::StatementPtr select;
 			db::Parameter * testId{};
-			db::Parameter * sTestId{};
 			db::Parameter * rendererId{};
-			db::Parameter * sRendererId{};
 			db::Parameter * runDate{};
-			db::Parameter * sRunDate{};
 			db::Parameter * status{};
-			db::Parameter * sStatus{};
 			db::Parameter * engineDate{};
-			db::Parameter * sEngineDate{};
 			db::Parameter * testDate{};
-			db::Parameter * sTestDate{};
 		};
 
 		struct InsertRun
 		{
 			InsertRun() = default;
 			explicit InsertRun( db::Connection & connection )
-				: stmt{ connection.createStatement( "INSERT INTO TestRun (TestId, RendererId, RunDate, Status, EngineDate, SceneDate, TotalTime, AvgFrameTime, LastFrameTime, HostId) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);" ) }
-				, select{ connection.createStatement( "SELECT Id FROM TestRun WHERE TestId=? AND RendererId=? AND RunDate=? AND Status=? AND EngineDate=? AND SceneDate=? AND TotalTime=? AND AvgFrameTime=? AND LastFrameTime=? AND HostId=?;" ) }
+				: connection{ &connection }
+				, stmt{ connection.createStatement( "INSERT INTO TestRun (TestId, RendererId, RunDate, Status, EngineDate, SceneDate, TotalTime, AvgFrameTime, LastFrameTime, HostId) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);" ) }
 				, testId{ stmt->createParameter( "TestId", db::FieldType::eSint32 ) }
-				, sTestId{ select->createParameter( "TestId", db::FieldType::eSint32 ) }
 				, rendererId{ stmt->createParameter( "RendererId", db::FieldType::eSint32 ) }
-				, sRendererId{ select->createParameter( "RendererId", db::FieldType::eSint32 ) }
 				, runDate{ stmt->createParameter( "RunDate", db::FieldType::eDatetime ) }
-				, sRunDate{ select->createParameter( "RunDate", db::FieldType::eDatetime ) }
 				, status{ stmt->createParameter( "Status", db::FieldType::eSint32 ) }
-				, sStatus{ select->createParameter( "Status", db::FieldType::eSint32 ) }
 				, engineDate{ stmt->createParameter( "EngineDate", db::FieldType::eDatetime ) }
-				, sEngineDate{ select->createParameter( "EngineDate", db::FieldType::eDatetime ) }
 				, testDate{ stmt->createParameter( "SceneDate", db::FieldType::eDatetime ) }
-				, sTestDate{ select->createParameter( "SceneDate", db::FieldType::eDatetime ) }
 				, totalTime{ stmt->createParameter( "TotalTime", db::FieldType::eUint32 ) }
-				, sTotalTime{ select->createParameter( "TotalTime", db::FieldType::eUint32 ) }
 				, avgFrameTime{ stmt->createParameter( "AvgFrameTime", db::FieldType::eUint32 ) }
-				, sAvgFrameTime{ select->createParameter( "AvgFrameTime", db::FieldType::eUint32 ) }
 				, lastFrameTime{ stmt->createParameter( "LastFrameTime", db::FieldType::eUint32 ) }
-				, sLastFrameTime{ select->createParameter( "LastFrameTime", db::FieldType::eUint32 ) }
 				, hostId{ stmt->createParameter( "HostId", db::FieldType::eSint32 ) }
-				, sHostId{ select->createParameter( "HostId", db::FieldType::eSint32 ) }
 			{
 				if ( !stmt->initialise() )
 				{
 					throw std::runtime_error{ "Couldn't create InsertRun INSERT statement." };
 				}
-
-				if ( !select->initialise() )
-				{
-					throw std::runtime_error{ "Couldn't create InsertRun SELECT statement." };
-				}
 			}
 
 			int32_t insert( int32_t id
@@ -461,28 +452,18 @@ namespace aria
 				, Host const & host );
 
 		private:
+			db::Connection * connection{};
 			db::StatementPtr stmt;
-			db::StatementPtr select;
 			db::Parameter * testId{};
-			db::Parameter * sTestId{};
 			db::Parameter * rendererId{};
-			db::Parameter * sRendererId{};
 			db::Parameter * runDate{};
-			db::Parameter * sRunDate{};
 			db::Parameter * status{};
-			db::Parameter * sStatus{};
 			db::Parameter * engineDate{};
-			db::Parameter * sEngineDate{};
 			db::Parameter * testDate{};
-			db::Parameter * sTestDate{};
 			db::Parameter * totalTime{};
-			db::Parameter * sTotalTime{};
 			db::Parameter * avgFrameTime{};
-			db::Parameter * sAvgFrameTime{};
 			db::Parameter * lastFrameTime{};
-			db::Parameter * sLastFrameTime{};
 			db::Parameter * hostId{};
-			db::Parameter * sHostId{};
 		};
 
 		struct UpdateTestIgnoreResult
@@ -712,12 +693,14 @@ namespace aria
 			}
 
 			TestMap listTests( CategoryMap & categories
-				, wxProgressDialog & progress
+				, Progress & progress
 				, int & index );
 			void listTests( CategoryMap & categories
 				, TestMap & result
-				, wxProgressDialog & progress
+				, Progress & progress
 				, int & index );
+			void listTests( CategoryMap & categories
+				, TestMap & result );
 
 		private:
 			db::StatementPtr stmt;
@@ -748,7 +731,7 @@ namespace aria
 			ListLatestRendererTests() = default;
 			explicit ListLatestRendererTests( TestDatabase * database )
 				: database{ database }
-				, stmt{ database->m_database.createStatement( "SELECT CategoryId, TestId, TestRun.Id, MAX(RunDate) AS RunDate, HostId, Status, EngineDate, SceneDate, TotalTime, AvgFrameTime, LastFrameTime FROM Test, TestRun WHERE Test.Id=TestRun.TestId AND RendererId=? GROUP BY CategoryId, TestId ORDER BY CategoryId, TestId; " ) }
+				, stmt{ database->m_database.createStatement( "SELECT CategoryId, LatestRun.TestId, TestRun.Id, RunDate, HostId, Status, EngineDate, SceneDate, TotalTime, AvgFrameTime, LastFrameTime FROM LatestRun, Test, TestRun WHERE LatestRun.RendererId=? AND Test.Id=LatestRun.TestId AND TestRun.Id=LatestRun.RunId ORDER BY CategoryId, LatestRun.TestId;" ) }
 				, rendererId{ stmt->createParameter( "RendererId", db::FieldType::eSint32 ) }
 			{
 				if ( !stmt->initialise() )
@@ -761,14 +744,14 @@ namespace aria
 				, HostMap & hosts
 				, CategoryMap & categories
 				, Renderer renderer
-				, wxProgressDialog & progress
+				, Progress & progress
 				, int & index );
 			void listTests( TestMap const & tests
 				, HostMap & hosts
 				, CategoryMap & categories
 				, Renderer renderer
 				, RendererTestRuns & result
-				, wxProgressDialog & progress
+				, Progress & progress
 				, int & index );
 
 		private:
@@ -777,11 +760,62 @@ namespace aria
 			db::Parameter * rendererId{};
 		};
 
+		struct ListLatestCategoryTests
+		{
+			ListLatestCategoryTests() = default;
+			explicit ListLatestCategoryTests( db::Connection & connection )
+				: stmt{ connection.createStatement( "SELECT CategoryId, LatestRun.TestId, TestRun.Id, RunDate, HostId, Status, EngineDate, SceneDate, TotalTime, AvgFrameTime, LastFrameTime FROM LatestRun, Test, TestRun WHERE LatestRun.RendererId=? AND Test.Id=LatestRun.TestId AND Test.CategoryId=? AND TestRun.Id=LatestRun.RunId ORDER BY LatestRun.TestId;" ) }
+				, rendererId{ stmt->createParameter( "RendererId", db::FieldType::eSint32 ) }
+				, categoryId{ stmt->createParameter( "CategoryId", db::FieldType::eSint32 ) }
+			{
+				if ( !stmt->initialise() )
+				{
+					throw std::runtime_error{ "Couldn't create ListLatestCategoryTests SELECT statement." };
+				}
+			}
+
+			DatabaseTestArray listTests( TestArray const & tests
+				, HostMap const & hosts
+				, Renderer renderer
+				, Category category
+				, RendererTestRuns & result );
+
+		private:
+			db::StatementPtr stmt;
+			db::Parameter * rendererId{};
+			db::Parameter * categoryId{};
+		};
+
+		struct CountLatestRendererTests
+		{
+			CountLatestRendererTests() = default;
+			explicit CountLatestRendererTests( db::Connection & connection )
+				: stmt{ connection.createStatement( "SELECT CategoryId, Status, COUNT(*), SUM(CASE WHEN TestRun.EngineDate IS NULL OR TestRun.EngineDate < ? THEN 1 ELSE 0 END) FROM LatestRun, Test, TestRun WHERE LatestRun.RendererId=? AND Test.Id=LatestRun.TestId AND TestRun.Id=LatestRun.RunId GROUP BY CategoryId, Status;" ) }
+				, engineRefDate{ stmt->createParameter( "EngineRefDate", db::FieldType::eDatetime ) }
+				, rendererId{ stmt->createParameter( "RendererId", db::FieldType::eSint32 ) }
+			{
+				if ( !stmt->initialise() )
+				{
+					throw std::runtime_error{ "Couldn't create CountLatestRendererTests SELECT statement." };
+				}
+			}
+
+			void countTests( TestMap const & tests
+				, Renderer renderer
+				, db::DateTime const & engineRefDate
+				, RendererTestsCounts & result );
+
+		private:
+			db::StatementPtr stmt;
+			db::Parameter * engineRefDate{};
+			db::Parameter * rendererId{};
+		};
+
 		struct ListTestRuns
 		{
 			ListTestRuns() = default;
-			explicit ListTestRuns( TestDatabase * database )
-				: stmt{ database->m_database.createStatement( "SELECT TestRun.Id, Status, RunDate, HostId, TotalTime, AvgFrameTime, LastFrameTime FROM TestRun WHERE TestId=? ORDER BY RunDate DESC;" ) }
+			explicit ListTestRuns( db::Connection & connection )
+				: stmt{ connection.createStatement( "SELECT TestRun.Id, Status, RunDate, HostId, TotalTime, AvgFrameTime, LastFrameTime FROM TestRun WHERE TestId=? ORDER BY RunDate DESC;" ) }
 				, id{ stmt->createParameter( "TestId", db::FieldType::eSint32 ) }
 			{
 				if ( !stmt->initialise() )
@@ -1084,25 +1118,63 @@ namespace aria
 			db::Parameter * status{};
 		};
 
+		// The statements used by the UI queries, on a read-only connection.
+		// In WAL mode, these read from a snapshot and don't wait for the writer.
+		struct ReadConnection
+		{
+			ReadConnection( wxFileName const & file
+				, db::ConnectionOptions const & options )
+				: connection{ file, options, true }
+				, listCategories{ connection }
+				, listTests{ connection }
+				, countLatestRendererRuns{ connection }
+				, listLatestCategoryRuns{ connection }
+				, listTestRuns{ connection }
+				, listTestHosts{ connection }
+				, listAllTimes{ connection }
+			{
+			}
+
+			db::Connection connection;
+			ListCategories listCategories;
+			ListTests listTests;
+			CountLatestRendererTests countLatestRendererRuns;
+			ListLatestCategoryTests listLatestCategoryRuns;
+			ListTestRuns listTestRuns;
+			ListTestHosts listTestHosts;
+			ListAllTimes listAllTimes;
+		};
+		using ReadConnectionPtr = std::unique_ptr< ReadConnection >;
+		using QueuedRun = std::pair< DatabaseTest *, TestRun >;
+
 	private:
 		void insertRun( TestRun & run
 			, bool moveFiles = true );
+		void queueRun( DatabaseTest & test );
 		void updateTestIgnoreResult( Test const & test
 			, bool ignore );
 		void updateRunStatus( TestRun const & run );
 		void updateRunEngineDate( TestRun const & run );
 		void updateRunTestDate( TestRun const & run );
-		void doCreateV1( wxProgressDialog & progress, int & index );
-		void doCreateV2( wxProgressDialog & progress, int & index );
-		void doCreateV3( wxProgressDialog & progress, int & index );
-		void doCreateV4( wxProgressDialog & progress, int & index );
-		void doCreateV5( wxProgressDialog & progress, int & index );
-		void doCreateV6( wxProgressDialog & progress, int & index );
+		void doCreateV1( Progress & progress, int & index );
+		void doCreateV2( Progress & progress, int & index );
+		void doCreateV3( Progress & progress, int & index );
+		void doCreateV4( Progress & progress, int & index );
+		void doCreateV5( Progress & progress, int & index );
+		void doCreateV6( Progress & progress, int & index );
+		void doCreateV7( Progress & progress, int & index );
+		void doCreateV8( Progress & progress, int & index );
+		void doCreateV9( Progress & progress, int & index );
+		void doInsertRun( TestRun & run
+			, bool moveFiles );
+		void doTouchDb();
+		ReadConnectionPtr doAcquireReader();
+		void doReleaseReader( ReadConnectionPtr reader );
 		void doUpdateCategories();
 		void doUpdateRenderers();
-		void doListCategories( wxProgressDialog & progress, int & index );
-		void doFillDatabase( wxProgressDialog & progress, int & index );
-		void doAssignTestKeywords( db::Result const & testNames, wxProgressDialog & progress, int & index );
+		void doListCategories( Progress & progress, int & index );
+		void doFillDatabase( Progress & progress, int & index );
+		void doAssignTestKeywords( db::Result const & testNames, Progress & progress, int & index );
 
 	private:
 		Plugin * m_plugin;
@@ -1142,6 +1214,8 @@ namespace aria
 		ListTests m_listTests;
 		ListLatestTestRun m_listLatestRun;
 		ListLatestRendererTests m_listLatestRendererRuns;
+		ListLatestCategoryTests m_listLatestCategoryRuns;
+		CountLatestRendererTests m_countLatestRendererRuns;
 		ListTestRuns m_listTestRuns;
 		DeleteRun m_deleteRun;
 		DeleteTest m_deleteTest;
@@ -1158,6 +1232,12 @@ namespace aria
 		GetDatabaseVersion m_getDatabaseVersion;
 		ListTestHosts m_listTestHosts;
 		ListAllTimes m_listAllTimes;
+		std::atomic_bool m_useReaders{};
+		std::mutex m_readersMutex;
+		std::vector< ReadConnectionPtr > m_readers;
+		std::recursive_mutex m_writerMutex;
+		std::mutex m_queuedRunsMutex;
+		std::vector< QueuedRun > m_queuedRuns;
 	};
 }
 
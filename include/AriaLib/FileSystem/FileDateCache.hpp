@@ -0,0 +1,78 @@
+/*
+See LICENSE file in root folder
+*/
+#ifndef ___ARIA_FileDateCache_HPP___
+#define ___ARIA_FileDateCache_HPP___
+
+#include "AriaLib/Prerequisites.hpp"
+
+#include "AriaLib/BeginExternHeaderGuard.hpp"
+#include <wx/event.h>
+#include <wx/filename.h>
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include "AriaLib/EndExternHeaderGuard.hpp"
+
+class wxFileSystemWatcherBase;
+class wxFileSystemWatcherEvent;
+
+namespace aria
+{
+	// Caches files modification dates, so that the out of date checks don't hit the disk.
+	// The folders of the cached files are watched (inotify on Linux), or polled from a thread when watching isn't available.
+	// A missing folder is watched through its nearest existing parent, until it is created.
+	// The changes are reported from the UI thread.
+	class FileDateCache
+		: public wxEvtHandler
+	{
+	public:
+		using OnChange = std::function< void( wxFileName const & file ) >;
+
+	public:
+		AriaLib_API FileDateCache();
+		AriaLib_API ~FileDateCache()override;
+
+		AriaLib_API db::DateTime get( wxFileName const & file );
+
+		void setOnChange( OnChange onChange )
+		{
+			m_onChange = std::move( onChange );
+		}
+
+	private:
+		void doWatchPending();
+		bool doWatch( wxString const & folder );
+		void doWatchCreated( wxString const & path );
+		void doStartPolling();
+		void doPoll();
+		std::vector< wxString > doListPaths();
+		std::vector< wxString > doRefresh( std::vector< wxString > const & paths );
+		void doNotify( std::vector< wxString > const & paths );
+		void onFileSystemEvent( wxFileSystemWatcherEvent & evt );
+
+	private:
+		std::mutex m_mutex;
+		std::map< wxString, db::DateTime > m_dates;
+		std::set< wxString > m_folders;
+		std::vector< wxString > m_pendingFolders;
+		// Only used from the UI thread.
+		std::unique_ptr< wxFileSystemWatcherBase > m_watcher;
+		std::set< wxString > m_watched;
+		std::set< wxString > m_missingFolders;
+		bool m_polling{};
+		// The polling thread stops when m_stopped is set, under m_mutex.
+		std::condition_variable m_pollCondition;
+		bool m_stopped{};
+		std::thread m_poller;
+		OnChange m_onChange;
+	};
+}
+
+#endif
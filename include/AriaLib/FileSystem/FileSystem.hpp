@@ -11,8 +11,11 @@ See LICENSE file in root folder
 #include <wx/filename.h>
 
 #include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <vector>
 #include "AriaLib/EndExternHeaderGuard.hpp"
@@ -58,8 +61,26 @@ namespace aria
 		AriaLib_API virtual bool isEnabled()const = 0;
 		AriaLib_API virtual bool isRemoving()const = 0;
 
+		void setOnPendingWork( std::function< void() > callback )
+		{
+			m_onPendingWork = std::move( callback );
+		}
+
+	protected:
+		// To be called by plugins when they have work to process in their step() function.
+		void notifyPendingWork()
+		{
+			if ( m_onPendingWork )
+			{
+				m_onPendingWork();
+			}
+		}
+
 	protected:
 		std::mutex * m_mutex;
+
+	private:
+		std::function< void() > m_onPendingWork;
 	};
 	using FileSystemPluginPtr = std::unique_ptr< FileSystemPlugin >;
 	using FileSystemPluginArray = std::vector< FileSystemPluginPtr >;
@@ -173,17 +194,36 @@ namespace aria
 
 		void run()override
 		{
-			if ( !isRunning() )
+			if ( !m_thread.joinable() )
 			{
 				m_stopped = false;
+				m_pendingWork = true;
+				getPlugin().setOnPendingWork( [this]()
+					{
+						auto lock( makeUniqueLock( m_workMutex ) );
+						m_pendingWork = true;
+						m_workCondition.notify_one();
+					} );
 				m_thread = std::thread{ [this]()
 					{
 						m_running = true;
+						auto lock( makeUniqueLock( m_workMutex ) );
 
 						while ( !isStopped() )
 						{
-							getPlugin().step();
-							wxMilliSleep( 5 );
+							m_workCondition.wait( lock
+								, [this]()
+								{
+									return m_pendingWork || isStopped();
+								} );
+
+							if ( m_pendingWork )
+							{
+								m_pendingWork = false;
+								lock.unlock();
+								getPlugin().step();
+								lock.lock();
+							}
 						}
 
 						m_running = false;
@@ -193,9 +233,13 @@ namespace aria
 
 		void stop()override
 		{
-			if ( isRunning() )
+			if ( m_thread.joinable() )
 			{
-				m_stopped = true;
+				{
+					auto lock( makeUniqueLock( m_workMutex ) );
+					m_stopped = true;
+				}
+				m_workCondition.notify_one();
 				m_thread.join();
 			}
 		}
@@ -213,6 +257,9 @@ namespace aria
 	private:
 		std::atomic_bool m_running{ false };
 		std::atomic_bool m_stopped{ false };
+		std::mutex m_workMutex;
+		std::condition_variable m_workCondition;
+		bool m_pendingWork{ false };
 		std::thread m_thread;
 	};
 	template< typename FileSystemPluginT >
@@ -261,8 +308,20 @@ namespace aria
 			, bool gitTracked );
 		AriaLib_API bool touch( wxString const & testName
 			, wxFileName const & file );
-		AriaLib_API void touchDb( wxFileName const & file );
+		// Marks the database as modified, it is added to the next commit.
+		AriaLib_API void touchDb();
 		AriaLib_API bool commit( wxString const & label );
+		// To be called by the plugins for each commit, including their own ones (auto save...).
+		// If the database has been modified, brings its file up to date, and returns it, to be added to the commit.
+		AriaLib_API std::optional< wxFileName > prepareDbCommit();
+
+		// onDbCommit brings the database file up to date, and returns false if it can't be done yet.
+		void setDatabase( wxFileName const & file
+			, std::function< bool() > onDbCommit )
+		{
+			m_database = file;
+			m_onDbCommit = std::move( onDbCommit );
+		}
 
 	private:
 		AriaLib_API void doRegisterPlugin( FileSystemPluginPtr plugin );
@@ -274,7 +333,10 @@ namespace aria
 
 	private:
 		FileSystemPluginArray m_plugins;
-		bool m_touchedDb;
+		// Touched from the database writers, read from the plugins commits.
+		std::atomic_bool m_touchedDb{};
+		wxFileName m_database;
+		std::function< bool() > m_onDbCommit;
 	};
 }
 
@@ -30,6 +30,12 @@ namespace aria
 		namespace df
 		{
 			static const uint32_t FrameCount{ 10u };
+			static const uint32_t ConcurrentRuns{ 1u };
+			static const wxString JournalMode{ wxT( "wal" ) };
+			static const wxString Synchronous{ wxT( "normal" ) };
+			static const int64_t MmapSize{ 256ll * 1024ll * 1024ll };
+			static const int64_t CacheSize{ -64ll * 1024ll };
+			static const wxString TempStore{ wxT( "memory" ) };
 		}
 
 		AriaLib_API wxString selectPlugin( PluginFactory const & factory );
@@ -125,10 +131,12 @@ namespace aria
 		Options & operator=( Options const & ) = delete;
 		Options( Options && ) = delete;
 		Options & operator=( Options && ) = delete;
+		// fillParser lets the executable add its own options, before the command line is parsed.
 		AriaLib_API Options( PluginFactory & factory
 			, std::vector< PluginLib > & pluginsLibs
 			, int argc
-			, wxCmdLineArgsArray const & argv );
+			, wxCmdLineArgsArray const & argv
+			, std::function< void( wxCmdLineParser & ) > const & fillParser = nullptr );
 		AriaLib_API ~Options() = default;
 
 		AriaLib_API bool has( wxString const & option )const;
@@ -5,6 +5,7 @@ See LICENSE file in root folder
 #define ___Aria_Plugin_HPP___
 
 #include "Prerequisites.hpp"
+#include "FileSystem/FileDateCache.hpp"
 
 #include "AriaLib/BeginExternHeaderGuard.hpp"
 #include <functional>
@@ -193,6 +194,8 @@ namespace aria
 
 	public:
 		Config config;
+		// The out of date checks read the files dates from here.
+		mutable FileDateCache fileDates;
 	};
 
 	AriaLib_API void addTextField( wxWindow & parent
@@ -234,6 +237,14 @@ namespace aria
 		, wxString const & tip
 		, wxFileName & value
 		, int topBorder );
+	AriaLib_API void addUIntField( wxWindow & parent
+		, wxSizer & parentSizer
+		, wxString const & name
+		, wxString const & tip
+		, uint32_t & value
+		, uint32_t minValue
+		, uint32_t maxValue
+		, int topBorder );
 }
 
 #endif
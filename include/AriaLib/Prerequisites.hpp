@@ -16,6 +16,7 @@ See LICENSE file in root folder
 #include <wx/fileconf.h>
 #include <wx/string.h>
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <list>
@@ -23,6 +24,7 @@ See LICENSE file in root folder
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include "AriaLib/EndExternHeaderGuard.hpp"
 
@@ -185,6 +187,7 @@ namespace aria
 	class Plugin;
 	class PluginConfig;
 	class PluginFactory;
+	class Progress;
 	class TestDatabase;
 	class LanguageInfo;
 	class StyleInfo;
@@ -279,9 +282,12 @@ namespace aria
 		wxFileName test;
 		wxFileName work;
 		wxFileName database;
+		db::ConnectionOptions databaseOptions;
 		std::vector< wxString > renderers;
 		bool initFromFolder{};
 		uint32_t maxFrameCount{ 10u };
+		uint32_t maxConcurrentRuns{ 1u };
+		uint32_t diffWorkers{ std::max( 1u, std::thread::hardware_concurrency() / 2u ) };
 		wxString plugin;
 	};
 
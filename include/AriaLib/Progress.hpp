@@ -0,0 +1,35 @@
+/*
+See LICENSE file in root folder
+*/
+#ifndef ___Aria_Progress_HPP___
+#define ___Aria_Progress_HPP___
+
+#include "Prerequisites.hpp"
+
+namespace aria
+{
+	// Reports the progress of the long database operations (creation, upgrades, listings),
+	// and asks for the choices they need, without depending on how they are displayed.
+	class Progress
+	{
+	public:
+		AriaLib_API virtual ~Progress() = default;
+
+		AriaLib_API virtual void setTitle( wxString const & title ) = 0;
+		AriaLib_API virtual int getRange()const = 0;
+		AriaLib_API virtual void setRange( int range ) = 0;
+		AriaLib_API virtual void update( int index ) = 0;
+		AriaLib_API virtual void update( int index
+			, wxString const & message ) = 0;
+		// Adapts the display to the latest message.
+		AriaLib_API virtual void fit() = 0;
+		// Selects among the choices, selections holds the proposed ones on input.
+		// Returns false if the selection has been cancelled.
+		AriaLib_API virtual bool select( wxString const & title
+			, wxString const & message
+			, wxArrayString const & choices
+			, wxArrayInt & selections ) = 0;
+	};
+}
+
+#endif
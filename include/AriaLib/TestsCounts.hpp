@@ -15,21 +15,34 @@ See LICENSE file in root folder
 
 namespace aria
 {
+	// The counts are a tree (category, renderer, all), each change is also applied to the parents,
+	// so that the totals are never recomputed.
 	struct TestsCounts
 	{
 	public:
-		AriaLib_API TestsCounts( Plugin const & plugin );
+		AriaLib_API TestsCounts( Plugin const & plugin
+			, TestsCounts * parent = nullptr );
+		AriaLib_API TestsCounts( TestsCounts const & ) = delete;
+		AriaLib_API TestsCounts & operator=( TestsCounts const & ) = delete;
+
 		AriaLib_API void addTest( DatabaseTest & test );
 		AriaLib_API void removeTest( DatabaseTest & test );
 
 		AriaLib_API void add( TestStatus status );
 		AriaLib_API void remove( TestStatus status );
+		AriaLib_API void add( TestStatus status
+			, uint32_t count );
 
 		AriaLib_API void add( TestsCounts const & counts );
 		AriaLib_API void remove( TestsCounts const & counts );
 		AriaLib_API void clear();
+		AriaLib_API void addIgnored();
+		AriaLib_API void removeIgnored();
+		AriaLib_API void addOutdated();
+		AriaLib_API void addOutdated( uint32_t count );
+		AriaLib_API void removeOutdated();
+		AriaLib_API void removeOutdated( uint32_t count );
 
-		AriaLib_API CountedUInt & getCount( TestsCountsType type );
 		AriaLib_API CountedUInt const & getCount( TestsCountsType type )const;
 		AriaLib_API uint32_t getValue( TestsCountsType type )const;
 		AriaLib_API uint32_t getStatusValue( TestStatus status )const;
@@ -38,26 +51,6 @@ namespace aria
 		AriaLib_API uint32_t getAllValue()const;
 		AriaLib_API uint32_t getAllRunStatus()const;
 
-		void addIgnored()
-		{
-			++getCount( TestsCountsType::eIgnored );
-		}
-
-		void removeIgnored()
-		{
-			--getCount( TestsCountsType::eIgnored );
-		}
-
-		void addOutdated()
-		{
-			++getCount( TestsCountsType::eOutdated );
-		}
-
-		void removeOutdated()
-		{
-			--getCount( TestsCountsType::eOutdated );
-		}
-
 		uint32_t getNotRunValue()const
 		{
 			return getValue( TestsCountsType::eNotRun );
@@ -110,27 +103,46 @@ namespace aria
 			, uint32_t count );
 		void remove( TestsCountsType type
 			, uint32_t count );
+		void doAddValue( TestsCountsType type
+			, uint32_t count );
+		void doRemoveValue( TestsCountsType type
+			, uint32_t count );
 
 	private:
 		std::array< CountedUInt, TestsCountsType::eCount > m_values{};
 		Plugin const & m_plugin;
+		TestsCounts * m_parent;
 	};
 
 	struct RendererTestsCounts
 	{
-		AriaLib_API explicit RendererTestsCounts( Plugin const & plugin );
+		AriaLib_API explicit RendererTestsCounts( Plugin const & plugin
+			, TestsCounts * parent = nullptr );
+		AriaLib_API RendererTestsCounts( RendererTestsCounts const & ) = delete;
+		AriaLib_API RendererTestsCounts & operator=( RendererTestsCounts const & ) = delete;
 
 		AriaLib_API TestsCounts & addCategory( Category category
 			, TestArray const & tests );
 		AriaLib_API TestsCounts & getCounts( Category category );
-		AriaLib_API uint32_t getValue( TestsCountsType type )const;
-		AriaLib_API uint32_t getAllValue()const;
+
+		uint32_t getValue( TestsCountsType type )const
+		{
+			return totals.getValue( type );
+		}
+
+		uint32_t getAllValue()const
+		{
+			return totals.getAllValue();
+		}
 
 		float getPercent( TestsCountsType type )const
 		{
-			return getAllValue()
-				? ( 100.0f * float( getValue( type ) ) ) / float( getAllValue() )
-				: 0.0f;
+			return totals.getPercent( type );
+		}
+
+		TestsCounts const & getTotals()const
+		{
+			return totals;
 		}
 
 		TestsCountsCategoryMap & getCategories()
@@ -140,6 +152,7 @@ namespace aria
 
 	private:
 		Plugin const & plugin;
+		TestsCounts totals;
 		TestsCountsCategoryMap categories;
 	};
 
@@ -156,18 +169,29 @@ namespace aria
 		AriaLib_API TestsCounts & getCategory( Renderer renderer
 			, Category category );
 
-		AriaLib_API uint32_t getValue( TestsCountsType type )const;
-		AriaLib_API uint32_t getAllValue()const;
+		uint32_t getValue( TestsCountsType type )const
+		{
+			return totals.getValue( type );
+		}
+
+		uint32_t getAllValue()const
+		{
+			return totals.getAllValue();
+		}
 
 		float getPercent( TestsCountsType type )const
 		{
-			return getAllValue()
-				? ( 100.0f * float( getValue( type ) ) ) / float( getAllValue() )
-				: 0.0f;
+			return totals.getPercent( type );
+		}
+
+		TestsCounts const & getTotals()const
+		{
+			return totals;
 		}
 
 	private:
 		Plugin const & plugin;
+		TestsCounts totals;
 		TestsCountsRendererMap renderers;
 	};
 }
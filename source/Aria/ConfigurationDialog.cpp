@@ -58,6 +58,22 @@ namespace aria
 			, m_newConfig.database
 			, wxFLP_OPEN
 			, 5 );
+		addUIntField( *cont
+			, *contFieldsSizer
+			, _( "Concurrent runs" )
+			, _( "The maximum number of tests run simultaneously, per renderer." )
+			, m_newConfig.maxConcurrentRuns
+			, 1u
+			, 64u
+			, 5 );
+		addUIntField( *cont
+			, *contFieldsSizer
+			, _( "Comparison threads" )
+			, _( "The number of threads comparing the tests outputs to their references, applied at next start." )
+			, m_newConfig.diffWorkers
+			, 1u
+			, 64u
+			, 5 );
 		contSizer->Add( contFieldsSizer, wxSizerFlags{}.Expand().Border( wxALL, 10 ) );
 		cont->SetSizer( contSizer );
 		contSizer->SetSizeHints( cont );
@@ -0,0 +1,164 @@
+#include "DbJobQueue.hpp"
+
+#include <AriaLib/Database/TestDatabase.hpp>
+
+namespace aria
+{
+	//*********************************************************************************************
+
+	namespace dbjobs
+	{
+		static bool process( std::string const & name
+			, DbJobQueue::Job const & job
+			, TestDatabase & database )
+		{
+			auto transaction = database.beginTransaction( name );
+
+			if ( !transaction )
+			{
+				wxLogError( "Failure: Couldn't begin transaction %s.", name.c_str() );
+				return false;
+			}
+
+			try
+			{
+				job();
+				transaction.commit();
+				return true;
+			}
+			catch ( std::exception & exc )
+			{
+				wxLogError( "Failure: %s.", exc.what() );
+			}
+			catch ( ... )
+			{
+				wxLogError( "Failure: Unknown exception." );
+			}
+
+			// ROLLBACK TO keeps the savepoint, it still has to be released.
+			transaction.rollback();
+			transaction.commit();
+			return false;
+		}
+	}
+
+	//*********************************************************************************************
+
+	DbJobQueue::DbJobQueue( TestDatabase & database
+		, OnProgress onProgress )
+		: m_database{ database }
+		, m_onProgress{ std::move( onProgress ) }
+		, m_thread{ [this]()
+			{
+				doRun();
+			} }
+	{
+	}
+
+	DbJobQueue::~DbJobQueue()
+	{
+		stop();
+	}
+
+	void DbJobQueue::push( std::string name
+		, Job job )
+	{
+		{
+			auto lock = std::unique_lock< std::mutex >( m_mutex );
+
+			if ( m_stopped )
+			{
+				return;
+			}
+
+			m_jobs.push_back( { std::move( name ), std::move( job ) } );
+			++m_total;
+		}
+		m_condition.notify_one();
+	}
+
+	void DbJobQueue::stop()
+	{
+		{
+			auto lock = std::unique_lock< std::mutex >( m_mutex );
+
+			if ( m_stopped )
+			{
+				return;
+			}
+
+			m_stopped = true;
+		}
+		m_condition.notify_all();
+
+		if ( m_thread.joinable() )
+		{
+			m_thread.join();
+		}
+	}
+
+	void DbJobQueue::doRun()
+	{
+		while ( true )
+		{
+			std::list< NamedJob > jobs;
+			{
+				auto lock = std::unique_lock< std::mutex >( m_mutex );
+				m_condition.wait( lock
+					, [this]()
+					{
+						return m_stopped || !m_jobs.empty();
+					} );
+
+				if ( m_jobs.empty() )
+				{
+					// Stopped, and all pending jobs have been processed.
+					return;
+				}
+
+				jobs = std::move( m_jobs );
+				m_jobs.clear();
+			}
+
+			doProcess( jobs );
+		}
+	}
+
+	void DbJobQueue::doProcess( std::list< NamedJob > & jobs )
+	{
+		// The other threads' writes wait for the batch end, instead of ending up in its transaction.
+		auto lock = m_database.lockWriter();
+		// Each job gets its own savepoint, nested in the batch one,
+		// so that a failing job doesn't discard the other ones.
+		auto batch = m_database.beginTransaction( "DbJobs" );
+
+		for ( auto & job : jobs )
+		{
+			dbjobs::process( job.name, job.job, m_database );
+			Progress progress{ job.name };
+			{
+				auto lock = std::unique_lock< std::mutex >( m_mutex );
+				progress.done = ++m_done;
+				progress.total = m_total;
+
+				if ( m_done == m_total )
+				{
+					m_done = 0u;
+					m_total = 0u;
+				}
+			}
+
+			if ( m_onProgress )
+			{
+				m_onProgress( progress );
+			}
+		}
+
+		if ( batch )
+		{
+			batch.commit();
+		}
+	}
+
+	//*********************************************************************************************
+}
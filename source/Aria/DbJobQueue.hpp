@@ -0,0 +1,69 @@
+/* See LICENSE file in root folder */
+#ifndef ___ARIA__DbJobQueue_HPP___
+#define ___ARIA__DbJobQueue_HPP___
+
+#include "Prerequisites.hpp"
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria
+{
+	// Processes database jobs on a single persistent thread.
+	// Jobs queued while another one runs are processed together, within one transaction.
+	// The progress callback is called from the worker thread.
+	class DbJobQueue
+	{
+	public:
+		struct Progress
+		{
+			std::string name;
+			uint32_t done{};
+			uint32_t total{};
+		};
+		using Job = std::function< void() >;
+		using OnProgress = std::function< void( Progress const & ) >;
+
+	public:
+		DbJobQueue( DbJobQueue const & ) = delete;
+		DbJobQueue & operator=( DbJobQueue const & ) = delete;
+		DbJobQueue( DbJobQueue && ) = delete;
+		DbJobQueue & operator=( DbJobQueue && ) = delete;
+		DbJobQueue( TestDatabase & database
+			, OnProgress onProgress );
+		~DbJobQueue();
+
+		void push( std::string name
+			, Job job );
+		void stop();
+
+	private:
+		struct NamedJob
+		{
+			std::string name;
+			Job job;
+		};
+
+		void doRun();
+		void doProcess( std::list< NamedJob > & jobs );
+
+	private:
+		TestDatabase & m_database;
+		OnProgress m_onProgress;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::list< NamedJob > m_jobs;
+		uint32_t m_done{};
+		uint32_t m_total{};
+		bool m_stopped{};
+		std::thread m_thread;
+	};
+}
+
+#endif
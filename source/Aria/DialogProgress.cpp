@@ -0,0 +1,71 @@
+#include "DialogProgress.hpp"
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <wx/choicdlg.h>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria
+{
+	//*********************************************************************************************
+
+	DialogProgress::DialogProgress( wxString const & title
+		, wxString const & message
+		, int maximum
+		, wxWindow * parent )
+		: m_dialog{ title, message, maximum, parent }
+	{
+	}
+
+	void DialogProgress::setTitle( wxString const & title )
+	{
+		m_dialog.SetTitle( title );
+	}
+
+	int DialogProgress::getRange()const
+	{
+		return m_dialog.GetRange();
+	}
+
+	void DialogProgress::setRange( int range )
+	{
+		m_dialog.SetRange( range );
+	}
+
+	void DialogProgress::update( int index )
+	{
+		m_dialog.Update( index );
+	}
+
+	void DialogProgress::update( int index
+		, wxString const & message )
+	{
+		m_dialog.Update( index, message );
+	}
+
+	void DialogProgress::fit()
+	{
+		m_dialog.Fit();
+	}
+
+	bool DialogProgress::select( wxString const & title
+		, wxString const & message
+		, wxArrayString const & choices
+		, wxArrayInt & selections )
+	{
+		wxMultiChoiceDialog dialog{ nullptr
+			, message
+			, title
+			, choices };
+		dialog.SetSelections( selections );
+
+		if ( dialog.ShowModal() != wxID_OK )
+		{
+			return false;
+		}
+
+		selections = dialog.GetSelections();
+		return true;
+	}
+
+	//*********************************************************************************************
+}
@@ -0,0 +1,43 @@
+/* See LICENSE file in root folder */
+#ifndef ___ARIA__DialogProgress_HPP___
+#define ___ARIA__DialogProgress_HPP___
+
+#include "Prerequisites.hpp"
+
+#include <AriaLib/Progress.hpp>
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <wx/progdlg.h>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria
+{
+	// Displays the database operations progress in a progress dialog,
+	// and the selections in multiple choices dialogs.
+	class DialogProgress
+		: public Progress
+	{
+	public:
+		DialogProgress( wxString const & title
+			, wxString const & message
+			, int maximum
+			, wxWindow * parent );
+
+		void setTitle( wxString const & title )override;
+		int getRange()const override;
+		void setRange( int range )override;
+		void update( int index )override;
+		void update( int index
+			, wxString const & message )override;
+		void fit()override;
+		bool select( wxString const & title
+			, wxString const & message
+			, wxArrayString const & choices
+			, wxArrayInt & selections )override;
+
+	private:
+		wxProgressDialog m_dialog;
+	};
+}
+
+#endif
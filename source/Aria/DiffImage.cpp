@@ -3,7 +3,19 @@
 #include <AriaLib/BeginExternHeaderGuard.hpp>
 #include <flip/FLIP.h>
 
+#include <wx/file.h>
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <AriaLib/EndExternHeaderGuard.hpp>
 
@@ -11,6 +23,29 @@ namespace aria
 {
 	//*********************************************************************************************
 
+	struct DecodedImage
+	{
+		DecodedImage( int width, int height )
+			: ycxcz{ width, height }
+		{
+		}
+
+		int getWidth()const
+		{
+			return ycxcz.getWidth();
+		}
+
+		int getHeight()const
+		{
+			return ycxcz.getHeight();
+		}
+
+		// The image, converted from sRGB to YCxCz, one plane per channel.
+		FLIP::simd::planes3 ycxcz;
+	};
+
+	//*********************************************************************************************
+
 	namespace diff
 	{
 		static wxFileName initialiseDir( wxFileName const & basePath
@@ -162,24 +197,174 @@ namespace aria
 			return result;
 		}
 
+		// sRGB to linear RGB conversion, for each 8 bits channel value.
+		static std::array< float, 256u > const & getLinearRGBTable()
+		{
+			static std::array< float, 256u > const result = []()
+			{
+				std::array< float, 256u > table;
+
+				for ( size_t i = 0u; i < table.size(); ++i )
+				{
+					table[i] = FLIP::color3::sRGB2LinearRGB( float( i ) / 255.0f );
+				}
+
+				return table;
+			}();
+			return result;
+		}
+
+		// Decodes the file straight to YCxCz, in a single pass.
+		static std::shared_ptr< DecodedImage > decodeImage( wxFileName const & file )
+		{
+#if !defined( NDEBUG )
+			static bool const kernelsMatch = FLIP::simd::checkKernels();
+			assert( kernelsMatch
+				&& "DiffImage: decodeImage - The vectorised FLIP kernels don't match the scalar ones" );
+#endif
+			int width, height, bpp;
+			auto pixels = stbi_load( file.GetFullPath().ToStdString().c_str(), &width, &height, &bpp, 3 );
+
+			if ( !pixels )
+			{
+				wxLogError( wxString{} << "Couldn't decode image [" << file << "]." );
+				return nullptr;
+			}
+
+			auto result = std::make_shared< DecodedImage >( width, height );
+			auto & linear = getLinearRGBTable();
+
+#pragma omp parallel for
+			for ( int y = 0; y < height; y++ )
+			{
+				auto src = &pixels[3 * size_t( y ) * size_t( width )];
+				auto r = result->ycxcz.getRow( 0, y );
+				auto g = result->ycxcz.getRow( 1, y );
+				auto b = result->ycxcz.getRow( 2, y );
+
+				for ( int x = 0; x < width; x++ )
+				{
+					r[x] = linear[*src++];
+					g[x] = linear[*src++];
+					b[x] = linear[*src++];
+				}
+
+				FLIP::simd::linearRGB2YCxCz( r, g, b, width );
+			}
+
+			stbi_image_free( pixels );
+			return result;
+		}
+
+		// LRU cache of decoded reference images, keyed by path and modification time.
+		// Its size is bounded by the memory used by the decoded images, rather than by their count.
+		class ReferenceCache
+		{
+		public:
+			DecodedImagePtr get( wxFileName const & file )
+			{
+				auto path = file.GetFullPath();
+				auto date = file.GetModificationTime();
+				{
+					auto lock = std::unique_lock< std::mutex >( m_mutex );
+					auto it = std::find_if( m_entries.begin()
+						, m_entries.end()
+						, [&path]( Entry const & lookup )
+						{
+							return lookup.path == path;
+						} );
+
+					if ( it != m_entries.end() )
+					{
+						if ( it->date == date )
+						{
+							m_entries.splice( m_entries.begin(), m_entries, it );
+							return it->image;
+						}
+
+						doErase( it );
+					}
+				}
+
+				DecodedImagePtr result = decodeImage( file );
+
+				if ( result )
+				{
+					auto lock = std::unique_lock< std::mutex >( m_mutex );
+					m_entries.push_front( { path, date, result } );
+					m_size += getSize( *result );
+
+					// The latest image is always kept, even if it exceeds the limit alone.
+					while ( m_size > MaxSize
+						&& m_entries.size() > 1u )
+					{
+						doErase( std::prev( m_entries.end() ) );
+					}
+				}
+
+				return result;
+			}
+
+		private:
+			struct Entry
+			{
+				wxString path;
+				wxDateTime date;
+				DecodedImagePtr image;
+			};
+
+			static size_t getSize( DecodedImage const & image )
+			{
+				return 3u * sizeof( float ) * size_t( image.getWidth() ) * size_t( image.getHeight() );
+			}
+
+			void doErase( std::list< Entry >::iterator it )
+			{
+				m_size -= getSize( *it->image );
+				m_entries.erase( it );
+			}
+
+		private:
+			// Around ten 1080p references, or two 4K ones.
+			static size_t constexpr MaxSize = 256u * 1024u * 1024u;
+			std::mutex m_mutex;
+			std::list< Entry > m_entries;
+			size_t m_size{};
+		};
+
+		static ReferenceCache gReferenceCache;
+
+		static float getPPD()
+		{
+			return calculatePPD( gFLIPOptions.monitorDistance, gFLIPOptions.monitorResolutionX, gFLIPOptions.monitorWidth );
+		}
+
+		static FLIP::image< float > getFlipDiff( DecodedImage const & referenceImage
+			, DecodedImage const & testImage )
+		{
+			FLIP::image< float > errorMapFLIP( referenceImage.getWidth(), referenceImage.getHeight() );
+			errorMapFLIP.FLIPYCxCz( referenceImage.ycxcz
+				, testImage.ycxcz
+				, getPPD() );
+			return errorMapFLIP;
+		}
+
 		static FLIP::image< float > getFlipDiff( wxFileName const & refFile
 			, wxFileName const & testFile )
 		{
-			FLIP::image< FLIP::color3 > referenceImage( refFile.GetFullPath().ToStdString() );
-			FLIP::image< FLIP::color3 > testImage( testFile.GetFullPath().ToStdString() );
+			auto referenceImage = gReferenceCache.get( refFile );
+			auto testImage = decodeImage( testFile );
 
-			if ( testImage.getWidth() != referenceImage.getWidth()
-				|| testImage.getHeight() != referenceImage.getHeight() )
+			if ( !referenceImage
+				|| !testImage
+				|| testImage->getWidth() != referenceImage->getWidth()
+				|| testImage->getHeight() != referenceImage->getHeight() )
 			{
 				wxLogError( "CompareImages - Images dimensions don't match: " + testFile.GetFullPath() );
 				return FLIP::image< float >{ 1, 1 };
 			}
 
-			FLIP::image< float > errorMapFLIP( referenceImage.getWidth(), referenceImage.getHeight() );
-			errorMapFLIP.FLIP( referenceImage
-				, testImage
-				, calculatePPD( gFLIPOptions.monitorDistance, gFLIPOptions.monitorResolutionX, gFLIPOptions.monitorWidth ) );
-			return errorMapFLIP;
+			return getFlipDiff( *referenceImage, *testImage );
 		}
 
 		static wxImage getImageDiffFlip( wxFileName const & refFile
@@ -189,23 +374,313 @@ namespace aria
 			return convert( diff );
 		}
 
-		static double compareImages( wxFileName const & refFile
-			, wxFileName const & testFile )
+		static double compareImages( DecodedImage const & referenceImage
+			, DecodedImage const & testImage )
 		{
-			FLIP::image< float > errorMapFLIP = getFlipDiff( refFile, testFile );
-			pooling< float > pooledValues;
+			FLIP::image< float > errorMapFLIP = getFlipDiff( referenceImage, testImage );
+			double sum{};
 
 			for ( int y = 0; y < errorMapFLIP.getHeight(); y++ )
 			{
 				for ( int x = 0; x < errorMapFLIP.getWidth(); x++ )
 				{
-					pooledValues.update( uint32_t( x )
-						, uint32_t( y )
-						, errorMapFLIP.get( x, y ) );
+					sum += errorMapFLIP.get( x, y );
+				}
+			}
+
+			return sum / ( double( errorMapFLIP.getWidth() ) * errorMapFLIP.getHeight() );
+		}
+
+		static FLIP::simd::planes3 cropRows( FLIP::simd::planes3 const & image
+			, int begin
+			, int end )
+		{
+			FLIP::simd::planes3 result{ image.getWidth(), end - begin };
+
+			for ( int c = 0; c < 3; ++c )
+			{
+				std::memcpy( result.getPlane( c )
+					, image.getRow( c, begin )
+					, sizeof( float ) * size_t( image.getWidth() ) * size_t( end - begin ) );
+			}
+
+			return result;
+		}
+
+		// Computes the mean FLIP error band by band, and stops as soon as it reaches threshold.
+		// Since errors are positive, the returned value is then a lower bound of the mean, which is enough to classify the image.
+		static double compareImagesUntil( DecodedImage const & referenceImage
+			, DecodedImage const & testImage
+			, double threshold )
+		{
+			auto ppd = getPPD();
+			// Each band is evaluated with enough rows around it for both the spatial and feature filters.
+			auto halo = std::max( FLIP::calculateSpatialFilterRadius( ppd )
+				, int( std::ceil( 3.0f * 0.5f * FLIP::FLIPConstants.gw * ppd ) ) );
+			auto bandHeight = std::max( 128, 8 * halo );
+			auto width = referenceImage.getWidth();
+			auto height = referenceImage.getHeight();
+
+			if ( bandHeight >= height )
+			{
+				return compareImages( referenceImage, testImage );
+			}
+
+			auto count = double( width ) * height;
+			double sum{};
+
+			for ( int begin = 0; begin < height; begin += bandHeight )
+			{
+				auto end = std::min( height, begin + bandHeight );
+				auto cropBegin = std::max( 0, begin - halo );
+				auto cropEnd = std::min( height, end + halo );
+				FLIP::image< float > errorMapFLIP( width, cropEnd - cropBegin );
+				errorMapFLIP.FLIPYCxCz( cropRows( referenceImage.ycxcz, cropBegin, cropEnd )
+					, cropRows( testImage.ycxcz, cropBegin, cropEnd )
+					, ppd );
+
+				for ( int y = begin; y < end; y++ )
+				{
+					for ( int x = 0; x < width; x++ )
+					{
+						sum += errorMapFLIP.get( x, y - cropBegin );
+					}
+				}
+
+				if ( sum / count >= threshold )
+				{
+					break;
+				}
+			}
+
+			return sum / count;
+		}
+
+		static bool areIdentical( DecodedImage const & lhs
+			, DecodedImage const & rhs )
+		{
+			auto size = sizeof( float ) * size_t( lhs.getWidth() ) * size_t( lhs.getHeight() );
+
+			for ( int c = 0; c < 3; ++c )
+			{
+				if ( std::memcmp( lhs.ycxcz.getPlane( c ), rhs.ycxcz.getPlane( c ), size ) )
+				{
+					return false;
 				}
 			}
 
-			return pooledValues.getMean();
+			return true;
+		}
+
+		static bool areIdentical( wxFileName const & lhs
+			, wxFileName const & rhs )
+		{
+			if ( lhs.GetSize() != rhs.GetSize() )
+			{
+				return false;
+			}
+
+			std::ifstream lhsFile{ lhs.GetFullPath().ToStdString(), std::ios::binary };
+			std::ifstream rhsFile{ rhs.GetFullPath().ToStdString(), std::ios::binary };
+
+			if ( !lhsFile || !rhsFile )
+			{
+				return false;
+			}
+
+			std::array< char, 65536u > lhsBuffer;
+			std::array< char, 65536u > rhsBuffer;
+
+			while ( lhsFile && rhsFile )
+			{
+				lhsFile.read( lhsBuffer.data(), std::streamsize( lhsBuffer.size() ) );
+				rhsFile.read( rhsBuffer.data(), std::streamsize( rhsBuffer.size() ) );
+
+				if ( lhsFile.gcount() != rhsFile.gcount()
+					|| std::memcmp( lhsBuffer.data(), rhsBuffer.data(), size_t( lhsFile.gcount() ) ) )
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		// FNV-1a hash of the file contents.
+		static std::optional< uint64_t > hashFile( wxFileName const & file )
+		{
+			wxFile stream;
+
+			if ( !file.FileExists()
+				|| !stream.Open( file.GetFullPath() ) )
+			{
+				return std::nullopt;
+			}
+
+			uint64_t result = 14695981039346656037ull;
+			std::array< char, 65536u > buffer;
+			ssize_t read;
+
+			while ( ( read = stream.Read( buffer.data(), buffer.size() ) ) > 0 )
+			{
+				auto end = buffer.begin() + read;
+
+				for ( auto it = buffer.begin(); it != end; ++it )
+				{
+					result = ( result ^ uint8_t( *it ) ) * 1099511628211ull;
+				}
+			}
+
+			return result;
+		}
+
+		// Results of previous comparisons, by reference and output hashes.
+		// They are appended to a text file, so that they persist between sessions,
+		// and the file is compacted when loaded.
+		class ResultCache
+		{
+		public:
+			struct Entry
+			{
+				double ratio;
+				// false when the evaluation stopped early, the ratio is then a lower bound.
+				bool exact;
+			};
+
+			std::optional< Entry > find( wxFileName const & file
+				, uint64_t reference
+				, uint64_t output )
+			{
+				auto lock = std::unique_lock< std::mutex >( m_mutex );
+				doLoad( file );
+				auto it = m_entries.find( { reference, output } );
+
+				if ( it == m_entries.end() )
+				{
+					return std::nullopt;
+				}
+
+				return it->second;
+			}
+
+			void add( wxFileName const & file
+				, uint64_t reference
+				, uint64_t output
+				, Entry entry )
+			{
+				auto lock = std::unique_lock< std::mutex >( m_mutex );
+				doLoad( file );
+				m_entries[{ reference, output }] = entry;
+				wxFile stream;
+
+				if ( stream.Open( m_path, wxFile::write_append ) )
+				{
+					auto line = doFormat( { reference, output }, entry );
+					stream.Write( line.data(), line.size() );
+				}
+			}
+
+		private:
+			using Key = std::pair< uint64_t, uint64_t >;
+
+			static std::string doFormat( Key const & key
+				, Entry const & entry )
+			{
+				std::ostringstream stream;
+				stream << std::hex << key.first << " " << key.second
+					<< std::dec << std::setprecision( 17 ) << " " << entry.ratio
+					<< " " << entry.exact << "\n";
+				return stream.str();
+			}
+
+			void doLoad( wxFileName const & file )
+			{
+				auto path = file.GetFullPath();
+
+				if ( path == m_path )
+				{
+					return;
+				}
+
+				m_path = path;
+				m_entries.clear();
+				wxFile stream;
+
+				if ( !wxFileExists( m_path )
+					|| !stream.Open( m_path ) )
+				{
+					return;
+				}
+
+				wxString content;
+				stream.ReadAll( &content, wxConvUTF8 );
+				stream.Close();
+				std::istringstream lines{ makeStdString( content ) };
+				std::string line;
+				size_t count{};
+
+				// Later lines override earlier ones, invalid lines are skipped.
+				while ( std::getline( lines, line ) )
+				{
+					std::istringstream fields{ line };
+					Key key;
+					Entry entry;
+
+					++count;
+
+					if ( fields >> std::hex >> key.first >> key.second >> std::dec >> entry.ratio >> entry.exact )
+					{
+						m_entries[key] = entry;
+					}
+				}
+
+				if ( count != m_entries.size() )
+				{
+					doCompact();
+				}
+			}
+
+			// Rewrites the file with only the latest valid line for each key.
+			void doCompact()
+			{
+				std::string content;
+
+				for ( auto & [key, entry] : m_entries )
+				{
+					content += doFormat( key, entry );
+				}
+
+				auto tmpPath = m_path + wxT( ".tmp" );
+				wxFile stream;
+
+				if ( stream.Create( tmpPath, true )
+					&& stream.Write( content.data(), content.size() ) == content.size()
+					&& stream.Close() )
+				{
+					wxRenameFile( tmpPath, m_path, true );
+				}
+				else
+				{
+					wxLogWarning( wxString{} << "Couldn't compact the comparison results cache [" << m_path << "]." );
+				}
+			}
+
+		private:
+			std::mutex m_mutex;
+			wxString m_path;
+			std::map< Key, Entry > m_entries;
+		};
+
+		static ResultCache gResultCache;
+
+		static DiffResult getResult( DiffOptions const & options
+			, double ratio )
+		{
+			return ( ratio < options.acceptableThreshold
+				? ( ratio < options.negligibleThreshold
+					? DiffResult::eNegligible
+					: DiffResult::eAcceptable )
+				: DiffResult::eUnacceptable );
 		}
 	}
 
@@ -230,7 +705,10 @@ namespace aria
 			throw std::runtime_error{ "Reference image does not exist." };
 		}
 
-		reference = wxImage{ options.input.GetFullPath() };
+		if ( options.resultCache.IsOk() )
+		{
+			referenceHash = diff::hashFile( options.input );
+		}
 	}
 
 	//*********************************************************************************************
@@ -289,29 +767,79 @@ namespace aria
 			return DiffResult::eUnprocessed;
 		}
 
-		wxImage toTest{ compFile.GetFullPath() };
-		bool carryOn = config.reference.GetSize() == toTest.GetSize();
-		DiffResult result = DiffResult::eUnacceptable;
+		std::optional< double > ratio;
+		std::optional< uint64_t > outputHash;
 
-		if ( !carryOn )
+		if ( config.referenceHash )
 		{
-			wxLogError( wxString{} << "Output image [" << compFile << "]'s dimensions don't match reference image's dimensions." );
+			outputHash = diff::hashFile( compFile );
+
+			if ( outputHash )
+			{
+				auto entry = diff::gResultCache.find( options.resultCache, *config.referenceHash, *outputHash );
+
+				if ( entry
+					&& ( entry->exact || entry->ratio >= options.acceptableThreshold ) )
+				{
+					ratio = entry->ratio;
+				}
+			}
 		}
-		else
+
+		if ( !ratio
+			&& options.earlyExit
+			&& diff::areIdentical( options.input, compFile ) )
 		{
-			auto ratio = diff::compareImages( options.input, compFile );
-			result = ( ratio < options.acceptableThreshold
-				? ( ratio < options.negligibleThreshold
-					? DiffResult::eNegligible
-					: DiffResult::eAcceptable )
-				: DiffResult::eUnacceptable );
+			ratio = 0.0;
+		}
 
-			if ( result == DiffResult::eUnacceptable )
+		if ( !ratio )
+		{
+			auto reference = diff::gReferenceCache.get( options.input );
+			auto toTest = diff::decodeImage( compFile );
+			bool carryOn = reference
+				&& toTest
+				&& reference->getWidth() == toTest->getWidth()
+				&& reference->getHeight() == toTest->getHeight();
+
+			if ( !carryOn )
+			{
+				wxLogError( wxString{} << "Output image [" << compFile << "]'s dimensions don't match reference image's dimensions." );
+			}
+			else
 			{
-				wxLogError( wxString{} << "Output image [" << compFile.GetFullName() << "] doesn't match reference image [" << options.input.GetFullName() << "]." );
+				if ( !options.earlyExit )
+				{
+					ratio = diff::compareImages( *reference, *toTest );
+				}
+				else if ( !diff::areIdentical( *reference, *toTest ) )
+				{
+					ratio = diff::compareImagesUntil( *reference, *toTest, options.acceptableThreshold );
+				}
+				else
+				{
+					ratio = 0.0;
+				}
+
+				if ( outputHash )
+				{
+					diff::gResultCache.add( options.resultCache
+						, *config.referenceHash
+						, *outputHash
+						, { *ratio, !options.earlyExit || *ratio < options.acceptableThreshold } );
+				}
 			}
 		}
 
+		DiffResult result = ratio
+			? diff::getResult( options, *ratio )
+			: DiffResult::eUnacceptable;
+
+		if ( ratio && result == DiffResult::eUnacceptable )
+		{
+			wxLogError( wxString{} << "Output image [" << compFile.GetFullName() << "] doesn't match reference image [" << options.input.GetFullName() << "]." );
+		}
+
 		diff::moveOutput( compFile, config.dirs[size_t( result )]
 			, result == DiffResult::eUnacceptable );
 		return result;
@@ -8,6 +8,8 @@
 #include <wx/image.h>
 
 #include <array>
+#include <memory>
+#include <optional>
 #include <vector>
 #include <AriaLib/EndExternHeaderGuard.hpp>
 
@@ -20,6 +22,10 @@ namespace aria
 		double acceptableThreshold = 0.1;
 		double negligibleThreshold = 0.001;
 		DiffMode mode = DiffMode::eLogarithmic;
+		// Skips the FLIP evaluation for identical images, and stops it as soon as the output is known to be unacceptable.
+		bool earlyExit = true;
+		// File storing the results of previous comparisons, by images contents (no caching if empty).
+		wxFileName resultCache;
 	};
 
 	enum class DiffResult
@@ -31,11 +37,15 @@ namespace aria
 		eCount,
 	};
 
+	// An image decoded once, in the form consumed by the comparison.
+	struct DecodedImage;
+	using DecodedImagePtr = std::shared_ptr< DecodedImage const >;
+
 	struct DiffConfig
 	{
 		explicit DiffConfig( DiffOptions const & options );
 
-		wxImage reference;
+		std::optional< uint64_t > referenceHash;
 		std::array< wxFileName, size_t( DiffResult::eCount ) > dirs;
 	};
 
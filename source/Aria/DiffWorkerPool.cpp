@@ -0,0 +1,112 @@
+#include "DiffWorkerPool.hpp"
+
+namespace aria
+{
+	//*********************************************************************************************
+
+	DiffWorkerPool::DiffWorkerPool( uint32_t count )
+	{
+		count = std::max( 1u, count );
+
+		for ( uint32_t i = 0u; i < count; ++i )
+		{
+			m_threads.emplace_back( [this]()
+				{
+					doRun();
+				} );
+		}
+	}
+
+	DiffWorkerPool::~DiffWorkerPool()
+	{
+		stop();
+	}
+
+	void DiffWorkerPool::push( DiffOptions options
+		, OnDiffEnd onEnd )
+	{
+		{
+			auto lock = std::unique_lock< std::mutex >( m_mutex );
+			m_jobs.push_back( { std::move( options ), std::move( onEnd ) } );
+		}
+		m_condition.notify_one();
+	}
+
+	void DiffWorkerPool::stop()
+	{
+		{
+			auto lock = std::unique_lock< std::mutex >( m_mutex );
+
+			if ( m_stopped )
+			{
+				return;
+			}
+
+			m_stopped = true;
+			m_jobs.clear();
+		}
+		m_condition.notify_all();
+
+		for ( auto & thread : m_threads )
+		{
+			thread.join();
+		}
+
+		m_threads.clear();
+	}
+
+	void DiffWorkerPool::doRun()
+	{
+		while ( true )
+		{
+			Job job;
+			{
+				auto lock = std::unique_lock< std::mutex >( m_mutex );
+				m_condition.wait( lock
+					, [this]()
+					{
+						return m_stopped || !m_jobs.empty();
+					} );
+
+				if ( m_stopped )
+				{
+					return;
+				}
+
+				job = std::move( m_jobs.front() );
+				m_jobs.pop_front();
+			}
+
+			job.onEnd( doProcess( job.options ) );
+		}
+	}
+
+	DiffWorkerPool::Result DiffWorkerPool::doProcess( DiffOptions const & options )
+	{
+		Result result;
+
+		try
+		{
+			DiffConfig config{ options };
+
+			for ( auto & output : options.outputs )
+			{
+				auto diff = compareImages( options, config, output );
+				result.results.push_back( diff );
+				result.files.push_back( config.dirs[size_t( diff )] / output.GetFullName() );
+			}
+		}
+		catch ( std::exception & exc )
+		{
+			result.error = exc.what();
+		}
+		catch ( ... )
+		{
+			result.error = "Unknown exception";
+		}
+
+		return result;
+	}
+
+	//*********************************************************************************************
+}
@@ -0,0 +1,65 @@
+/* See LICENSE file in root folder */
+#ifndef ___ARIA__DiffWorkerPool_HPP___
+#define ___ARIA__DiffWorkerPool_HPP___
+
+#include "DiffImage.hpp"
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria
+{
+	// Compares test outputs to their reference on worker threads.
+	// The completion callback is called from the worker thread.
+	class DiffWorkerPool
+	{
+	public:
+		struct Result
+		{
+			std::vector< DiffResult > results;
+			// Where the outputs have been moved to, matching the results.
+			std::vector< wxFileName > files;
+			// Not empty when the comparison couldn't happen.
+			std::string error;
+		};
+		using OnDiffEnd = std::function< void( Result const & ) >;
+
+	public:
+		DiffWorkerPool( DiffWorkerPool const & ) = delete;
+		DiffWorkerPool & operator=( DiffWorkerPool const & ) = delete;
+		DiffWorkerPool( DiffWorkerPool && ) = delete;
+		DiffWorkerPool & operator=( DiffWorkerPool && ) = delete;
+		explicit DiffWorkerPool( uint32_t count );
+		~DiffWorkerPool();
+
+		void push( DiffOptions options
+			, OnDiffEnd onEnd );
+		void stop();
+
+	private:
+		struct Job
+		{
+			DiffOptions options;
+			OnDiffEnd onEnd;
+		};
+
+		void doRun();
+		static Result doProcess( DiffOptions const & options );
+
+	private:
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::list< Job > m_jobs;
+		bool m_stopped{};
+		std::vector< std::thread > m_threads;
+	};
+}
+
+#endif
@@ -2,6 +2,9 @@
 
 #include <AriaLib/BeginExternHeaderGuard.hpp>
 #include <wx/sizer.h>
+
+#include <cstdio>
+#include <fstream>
 #include <AriaLib/EndExternHeaderGuard.hpp>
 
 #define ARIA_Git_UseAsync 1
@@ -20,6 +23,8 @@ namespace aria
 #endif
 		static int constexpr TimerWaitSeconds = 60 * 10;
 		static uint32_t constexpr MaxModifsToCommit = 50u;
+		// Keeps merged commands lines well under the platforms arguments length limits.
+		static size_t constexpr MaxCommandLength = 30000u;
 
 #if ARIA_GitSupport
 		static bool isGitRootDir( wxFileName const & curDir )
@@ -49,6 +54,30 @@ namespace aria
 			getGitRootDirRec( curDir, result );
 			return result;
 		}
+
+		// --pathspec-from-file is supported by add and rm since git 2.26.
+		static bool supportsPathspecFromFile( wxFileName const & gitCommand )
+		{
+			wxArrayString output;
+			wxArrayString errors;
+
+			if ( wxExecute( wxString{} << gitCommand << " --version", output, errors, wxEXEC_SYNC | wxEXEC_HIDE_CONSOLE ) != 0
+				|| output.empty() )
+			{
+				return false;
+			}
+
+			int major{};
+			int minor{};
+
+			if ( std::sscanf( output[0].ToStdString().c_str(), "git version %d.%d", &major, &minor ) != 2 )
+			{
+				return false;
+			}
+
+			return major > 2
+				|| ( major == 2 && minor >= 26 );
+		}
 #endif
 	}
 
@@ -83,6 +112,7 @@ namespace aria
 		: FileSystemPlugin{ mutex }
 		, wxEvtHandler{}
 		, m_parent{ parent }
+		, m_fileSystem{ fileSystem }
 		, m_handlerID{ handlerID }
 		, m_processes{ getProcesses( this, wxPROCESS_DEFAULT, eRemove + 1 ) }
 #if ARIA_GitSupport
@@ -141,6 +171,7 @@ namespace aria
 			{
 				if ( evt.GetId() == m_handlerID )
 				{
+					auto lock( makeUniqueLock( *m_mutex ) );
 					commit( "Auto save" );
 				}
 				else
@@ -161,6 +192,9 @@ namespace aria
 				}
 			} );
 		m_timer->Start( git::TimerWaitSeconds * 1000 );
+#if ARIA_GitSupport
+		m_pathspecFromFile = git::supportsPathspecFromFile( m_gitCommand );
+#endif
 
 		commit( "Launch" );
 	}
@@ -196,6 +230,12 @@ namespace aria
 		}
 	}
 
+	void Git::QueueEvent( wxEvent * event )
+	{
+		wxEvtHandler::QueueEvent( event );
+		notifyPendingWork();
+	}
+
 	bool Git::moveFolder( wxFileName const & base
 		, wxString const & oldName
 		, wxString const & newName )
@@ -228,7 +268,8 @@ namespace aria
 		}
 
 		return doPushLoggedCommand( "folder " + name
-			, makeCommand( eRemove, { relFile.GetFullPath() } )
+			, { relFile.GetFullPath() }
+			, wxString{}
 			, eRemove );
 	}
 
@@ -256,6 +297,15 @@ namespace aria
 			return false;
 		}
 
+		if ( relSrc.GetFullName() == relDst.GetFullName() )
+		{
+			// Moves to another folder can be merged with the other moves to the same folder.
+			return doPushLoggedCommand( "test " + testName
+				, { relSrc.GetFullPath() }
+				, relDst.GetPath()
+				, eMove );
+		}
+
 		return doPushLoggedCommand( "test " + testName
 			, makeCommand( eMove, { relSrc.GetFullPath(), relDst.GetFullPath() } )
 			, eMove );
@@ -296,7 +346,8 @@ namespace aria
 		}
 
 		return doPushLoggedCommand( "test " + testName
-			, makeCommand( eRemove, { relFile.GetFullPath() } )
+			, { relFile.GetFullPath() }
+			, wxString{}
 			, eRemove );
 	}
 
@@ -307,6 +358,11 @@ namespace aria
 			return true;
 		}
 
+		if ( auto database = m_fileSystem->prepareDbCommit() )
+		{
+			updateFile( "Database", *database );
+		}
+
 		return doPushLoggedCommand( label
 			, [this, label]()
 			{
@@ -323,7 +379,7 @@ namespace aria
 			, eCommit );
 	}
 
-	size_t Git::doPushCommand( Command command )
+	size_t Git::doQueueCommand( Command command )
 	{
 		auto commandType = command.type;
 		m_commands.emplace_back( std::move( command ) );
@@ -348,18 +404,120 @@ namespace aria
 	Git::Command Git::doGetNextCommand()
 	{
 		auto lock( makeUniqueLock( *m_mutex ) );
-		return doGetNextCommandNL();
+		auto result = std::move( m_commands.front() );
+		m_commands.pop_front();
+
+		if ( result.pathspecs.empty() )
+		{
+			return result;
+		}
+
+		// Merge the following commands of the same type in a single invocation.
+		size_t length{};
+		size_t merged{};
+
+		for ( auto & pathspec : result.pathspecs )
+		{
+			length += pathspec.size() + 1u;
+		}
+
+		while ( !m_commands.empty()
+			&& doCanMerge( result, m_commands.front(), length ) )
+		{
+			auto & next = m_commands.front();
+
+			for ( auto & pathspec : next.pathspecs )
+			{
+				length += pathspec.size() + 1u;
+				result.pathspecs.push_back( std::move( pathspec ) );
+			}
+
+			for ( auto & callback : next.callbacks )
+			{
+				result.callbacks.push_back( std::move( callback ) );
+			}
+
+			m_commands.pop_front();
+			++merged;
+		}
+
+		if ( merged )
+		{
+			result.label << " (+" << merged << ")";
+		}
+
+		return result;
+	}
+
+	bool Git::doCanMerge( Command const & lhs
+		, Command const & rhs
+		, size_t length )const
+	{
+		if ( lhs.type != rhs.type
+			|| rhs.pathspecs.empty()
+			|| lhs.destination != rhs.destination )
+		{
+			return false;
+		}
+
+		if ( m_pathspecFromFile
+			&& lhs.type != eMove )
+		{
+			return true;
+		}
+
+		for ( auto & pathspec : rhs.pathspecs )
+		{
+			length += pathspec.size() + 1u;
+		}
+
+		return length + lhs.destination.size() < git::MaxCommandLength;
 	}
 
-	Git::Command Git::doGetNextCommandNL()
+	wxString Git::doMakeCommand( Command & cmd )const
 	{
-		return m_commands.front();
+		if ( cmd.pathspecs.empty() )
+		{
+			return cmd.getCommand();
+		}
+
+		wxString result = getCommandName( cmd.type );
+
+		if ( m_pathspecFromFile
+			&& cmd.type != eMove
+			&& cmd.pathspecs.size() > 1u )
+		{
+			cmd.pathspecFile = wxFileName::CreateTempFileName( "aria-git" );
+			std::ofstream file{ cmd.pathspecFile.ToStdString(), std::ios::binary };
+
+			for ( auto & pathspec : cmd.pathspecs )
+			{
+				auto buffer = pathspec.ToUTF8();
+				file.write( buffer.data(), std::streamsize( buffer.length() ) );
+				file.put( '\0' );
+			}
+
+			result << " --pathspec-from-file=\"" << cmd.pathspecFile << "\" --pathspec-file-nul";
+			return result;
+		}
+
+		for ( auto & pathspec : cmd.pathspecs )
+		{
+			result << " " << pathspec;
+		}
+
+		if ( cmd.type == eMove )
+		{
+			result << " " << cmd.destination;
+		}
+
+		return result;
 	}
 
-	size_t Git::doPopCommand()
+	size_t Git::doEndCommand()
 	{
 		auto lock( makeUniqueLock( *m_mutex ) );
-		m_commands.erase( m_commands.begin() );
+		m_executing = !m_commands.empty();
 		return m_commands.size();
 	}
 
@@ -381,7 +539,8 @@ namespace aria
 		}
 
 		return doPushLoggedCommand( "test " + testName
-			, makeCommand( commandType, { relFile.GetFullPath() } )
+			, { relFile.GetFullPath() }
+			, wxString{}
 			, commandType );
 	}
 
@@ -396,17 +555,14 @@ namespace aria
 		m_parent->GetEventHandler()->QueueEvent( event );
 	}
 
-	bool Git::doPushCommand( CommandType commandType
-		, GetCommandCallback getCommand
-		, OnEndCallback callback
-		, wxProcess * process
-		, wxString const & label )
+	bool Git::doPushCommand( Command command )
 	{
 		bool result = true;
-		auto count = doPushCommand( { commandType, getCommand, callback, process, label } );
+		auto count = doQueueCommand( std::move( command ) );
 
-		if ( count == 1u )
+		if ( !m_executing )
 		{
+			m_executing = true;
 			doPushExecuteCommand( count );
 		}
 
@@ -426,29 +582,49 @@ namespace aria
 		, Git::GetCommandCallback getCommand
 		, Git::CommandType commandType )
 	{
-		return doPushCommand( commandType
-			, getCommand
-			, [this, commandType, testName]( int result )
+		return doPushCommand( { commandType
+			, std::move( getCommand )
+			, { doMakeLogCallback( testName, commandType ) }
+			, m_processes[commandType].get()
+			, getProcessName( commandType ) + " " + testName } );
+	}
+
+	bool Git::doPushLoggedCommand( wxString const & testName
+		, std::vector< wxString > pathspecs
+		, wxString const & destination
+		, Git::CommandType commandType )
+	{
+		return doPushCommand( { commandType
+			, nullptr
+			, { doMakeLogCallback( testName, commandType ) }
+			, m_processes[commandType].get()
+			, getProcessName( commandType ) + " " + testName
+			, std::move( pathspecs )
+			, destination } );
+	}
+
+	Git::OnEndCallback Git::doMakeLogCallback( wxString const & testName
+		, Git::CommandType commandType )
+	{
+		return [this, commandType, testName]( int result )
+		{
+			if ( result >= 0 )
 			{
-				if ( result >= 0 )
+				if ( commandType )
 				{
-					if ( commandType )
-					{
-						doLogModif( { commandType, testName } );
-					}
+					doLogModif( { commandType, testName } );
 				}
 			}
-			, m_processes[commandType].get()
-			, getProcessName( commandType ) + " " + testName );
+		};
 	}
 
 	bool Git::doExecuteCommand( Command cmd, size_t count )
 	{
 		m_gitProgress->SetRange( std::max( m_gitProgress->GetRange(), int( count ) ) );
-		m_gitProgress->SetValue( m_gitProgress->GetValue() + 1 );
+		m_gitProgress->SetValue( m_gitProgress->GetValue() + int( cmd.callbacks.size() ) );
 		m_gitProgress->Show();
 		wxString command;
-		command << m_gitCommand << " " << cmd.getCommand();
+		command << m_gitCommand << " " << doMakeCommand( cmd );
 		wxExecuteEnv execEnv;
 		execEnv.cwd = m_rootGitDir.GetFullPath();
 		auto result = wxExecute( command
@@ -473,16 +649,23 @@ namespace aria
 		sizer->Layout();
 		doRegisterOnEnd( int( result )
 			, command
-			, cmd.callback );
+			, cmd.pathspecFile
+			, std::move( cmd.callbacks ) );
 		return result >= 0;
 	}
 
 	void Git::doRegisterOnEnd( int result
 		, wxString const & command
-		, Git::OnEndCallback callback )
+		, wxString const & pathspecFile
+		, std::vector< Git::OnEndCallback > callbacks )
 	{
-		onEnd = [command, callback]( int res )
+		onEnd = [command, pathspecFile, callbacks]( int res )
 		{
+			if ( !pathspecFile.empty() )
+			{
+				wxRemoveFile( pathspecFile );
+			}
+
 			if ( res < 0 )
 			{
 				wxLogError( wxString() << "Git: " << "Command [" << command << "] failed (" << res << ")." );
@@ -492,7 +675,10 @@ namespace aria
 				wxLogWarning( wxString() << "Git: " << "Command [" << command << "] successful with warning (" << res << ")." );
 			}
 
-			callback( res );
+			for ( auto & callback : callbacks )
+			{
+				callback( res );
+			}
 		};
 #if !ARIA_Git_UseAsync
 		doEnd( result );
@@ -502,7 +688,7 @@ namespace aria
 	void Git::doEnd( int result )
 	{
 		onEnd( result );
-		auto count = doPopCommand();
+		auto count = doEndCommand();
 
 		if ( count )
 		{
@@ -15,6 +15,8 @@ See LICENSE file in root folder
 #include <wx/process.h>
 #include <wx/stattext.h>
 #include <wx/timer.h>
+
+#include <deque>
 #include <AriaLib/EndExternHeaderGuard.hpp>
 
 namespace aria
@@ -74,9 +76,14 @@ namespace aria
 		{
 			CommandType type;
 			GetCommandCallback getCommand;
-			OnEndCallback callback;
+			std::vector< OnEndCallback > callbacks;
 			wxProcess * process;
 			wxString label;
+			// When not empty, the command applies to these paths (moved to destination, for eMove),
+			// and can be merged with the following commands of the same type.
+			std::vector< wxString > pathspecs;
+			wxString destination;
+			wxString pathspecFile;
 		};
 
 		static wxString getCommandName( CommandType type )
@@ -126,6 +133,7 @@ namespace aria
 		void initialise()override;
 		void cleanup()override;
 		void step();
+		void QueueEvent( wxEvent * event )override;
 
 		bool moveFolder( wxFileName const & base
 			, wxString const & oldName
@@ -166,31 +174,37 @@ namespace aria
 		}
 
 	private:
-		size_t doPushCommand( Command command );
+		size_t doQueueCommand( Command command );
 		Command doGetNextCommand();
-		Command doGetNextCommandNL();
-		size_t doPopCommand();
+		size_t doEndCommand();
 		void doPushExecuteCommand( size_t count );
 
 		bool doAddFileMod( wxString const & testName
 			, wxFileName const & file
 			, CommandType commandType );
-		bool doPushCommand( CommandType commandType
-			, GetCommandCallback getCommand
-			, OnEndCallback callback
-			, wxProcess * process
-			, wxString const & label );
+		bool doPushCommand( Command command );
 		bool doPushLoggedCommand( wxString const & testName
 			, wxString const & command
 			, CommandType commandType );
 		bool doPushLoggedCommand( wxString const & testName
 			, GetCommandCallback getCommand
 			, CommandType commandType );
+		bool doPushLoggedCommand( wxString const & testName
+			, std::vector< wxString > pathspecs
+			, wxString const & destination
+			, CommandType commandType );
+		OnEndCallback doMakeLogCallback( wxString const & testName
+			, CommandType commandType );
+		bool doCanMerge( Command const & lhs
+			, Command const & rhs
+			, size_t length )const;
+		wxString doMakeCommand( Command & cmd )const;
 
 		bool doExecuteCommand( Command cmd, size_t count );
 		void doRegisterOnEnd( int result
 			, wxString const & command
-			, OnEndCallback callback );
+			, wxString const & pathspecFile
+			, std::vector< OnEndCallback > callbacks );
 		void doEnd( int result );
 		void doLogModif( CommandModif const & entry );
 
@@ -207,6 +221,7 @@ namespace aria
 
 	private:
 		wxFrame * m_parent{};
+		FileSystem * m_fileSystem{};
 		wxStaticText * m_gitText{};
 		wxGauge * m_gitProgress{};
 		wxWindowID m_handlerID{};
@@ -214,8 +229,11 @@ namespace aria
 		wxFileName m_rootGitDir;
 		wxFileName m_gitCommand;
 		bool m_enabled{};
+		bool m_pathspecFromFile{};
 		std::vector< CommandModif > m_modifs;
-		std::vector< Command > m_commands;
+		std::deque< Command > m_commands;
+		// true from the moment a command is scheduled for execution, until the queue is empty.
+		bool m_executing{};
 		uint32_t m_modifCommandCount{};
 		OnEndCallback onEnd;
 		wxTimer * m_timer{};
@@ -0,0 +1,496 @@
+#include "FileSystem/LibGit2FileSystemPlugin.hpp"
+
+#if ARIA_LibGit2Support
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <wx/dir.h>
+
+#include <git2.h>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria
+{
+	//*********************************************************************************************
+
+	namespace libgit2
+	{
+		static int constexpr TimerWaitSeconds = 60 * 10;
+		static uint32_t constexpr MaxModifsToCommit = 50u;
+
+		static bool check( int result
+			, wxString const & action )
+		{
+			if ( result < 0 )
+			{
+				auto error = git_error_last();
+				wxLogError( wxString() << "LibGit2: " << "Couldn't " << action << ": " << ( error ? error->message : "Unknown error" ) );
+				return false;
+			}
+
+			return true;
+		}
+	}
+
+	//*********************************************************************************************
+
+	LibGit2::LibGit2( wxFrame * parent
+		, wxWindowID handlerID
+		, FileSystem * fileSystem
+		, wxFileName const & curDir
+		, std::mutex * mutex )
+		: FileSystemPlugin{ mutex }
+		, m_parent{ parent }
+		, m_fileSystem{ fileSystem }
+		, m_handlerID{ handlerID }
+	{
+		git_libgit2_init();
+		git_buf rootDir{};
+
+		if ( git_repository_discover( &rootDir, curDir.GetFullPath().ToUTF8().data(), 0, nullptr ) == 0
+			&& libgit2::check( git_repository_open( &m_repository, rootDir.ptr ), "open repository" )
+			&& libgit2::check( git_repository_index( &m_index, m_repository ), "open index" ) )
+		{
+			m_rootGitDir = wxFileName::DirName( wxString::FromUTF8( git_repository_workdir( m_repository ) ) );
+			m_enabled = true;
+			m_timer = new wxTimer{ m_parent, m_handlerID };
+		}
+
+		git_buf_dispose( &rootDir );
+	}
+
+	LibGit2::~LibGit2()
+	{
+		git_index_free( m_index );
+		git_repository_free( m_repository );
+		git_libgit2_shutdown();
+	}
+
+	void LibGit2::initialise()
+	{
+		if ( !m_enabled )
+		{
+			return;
+		}
+
+		m_parent->Bind( wxEVT_TIMER
+			, [this]( wxTimerEvent & evt )
+			{
+				if ( evt.GetId() == m_handlerID )
+				{
+					auto lock( makeUniqueLock( *m_mutex ) );
+					commit( "Auto save" );
+				}
+				else
+				{
+					evt.Skip();
+				}
+			} );
+		m_timer->Start( libgit2::TimerWaitSeconds * 1000 );
+
+		commit( "Launch" );
+	}
+
+	void LibGit2::cleanup()
+	{
+		if ( !m_enabled )
+		{
+			return;
+		}
+
+		m_timer->Stop();
+		// The worker thread is stopped, process what it left.
+		step();
+	}
+
+	void LibGit2::step()
+	{
+		if ( !m_enabled )
+		{
+			return;
+		}
+
+		std::deque< Operation > operations;
+		{
+			auto lock( makeUniqueLock( m_operationsMutex ) );
+			std::swap( operations, m_operations );
+		}
+
+		if ( !operations.empty() )
+		{
+			doProcess( std::move( operations ) );
+		}
+	}
+
+	bool LibGit2::moveFolder( wxFileName const & base
+		, wxString const & oldName
+		, wxString const & newName )
+	{
+		if ( !m_enabled )
+		{
+			return true;
+		}
+
+		wxString relSrc;
+		wxString relDst;
+
+		if ( !doGetRelativePath( base / oldName, relSrc )
+			|| !doGetRelativePath( base / newName, relDst ) )
+		{
+			return false;
+		}
+
+		if ( !wxRenameFile( ( base / oldName ).GetFullPath(), ( base / newName ).GetFullPath() ) )
+		{
+			wxLogError( wxString() << "LibGit2: " << "Couldn't move folder [" << ( base / oldName ) << "]" );
+			return false;
+		}
+
+		return doPushOperation( { eMoveFolder, "category " + oldName, relSrc, relDst } );
+	}
+
+	bool LibGit2::removeFolder( wxFileName const & base
+		, wxString const & name )
+	{
+		if ( !m_enabled )
+		{
+			return false;
+		}
+
+		auto folder = base / name;
+		wxString relFolder;
+
+		if ( !doGetRelativePath( folder, relFolder ) )
+		{
+			return false;
+		}
+
+		if ( wxDir::Exists( folder.GetFullPath() ) )
+		{
+			wxFileName::Rmdir( folder.GetFullPath(), wxPATH_RMDIR_RECURSIVE );
+		}
+
+		return doPushOperation( { eRemoveFolder, "folder " + name, relFolder, wxString{} } );
+	}
+
+	bool LibGit2::moveFile( wxString const & testName
+		, wxFileName const & src
+		, wxFileName const & dst )
+	{
+		if ( !m_enabled )
+		{
+			return true;
+		}
+
+		wxString relSrc;
+		wxString relDst;
+
+		if ( !doGetRelativePath( src, relSrc )
+			|| !doGetRelativePath( dst, relDst ) )
+		{
+			return false;
+		}
+
+		if ( !wxRenameFile( src.GetFullPath(), dst.GetFullPath() ) )
+		{
+			wxLogError( wxString() << "LibGit2: " << "Couldn't move file [" << src << "] to [" << dst << "]" );
+			return false;
+		}
+
+		return doPushOperation( { eMove, "test " + testName, relSrc, relDst } );
+	}
+
+	bool LibGit2::addFileMod( wxString const & testName
+		, wxFileName const & file )
+	{
+		return doPushFileOperation( eTouch, testName, file );
+	}
+
+	bool LibGit2::addFile( wxString const & testName
+		, wxFileName const & file )
+	{
+		return doPushFileOperation( eAdd, testName, file );
+	}
+
+	bool LibGit2::updateFile( wxString const & testName
+		, wxFileName const & file )
+	{
+		return doPushFileOperation( eUpdate, testName, file );
+	}
+
+	bool LibGit2::removeFile( wxString const & testName
+		, wxFileName const & file )
+	{
+		if ( !m_enabled )
+		{
+			return false;
+		}
+
+		wxString relFile;
+
+		if ( !doGetRelativePath( file, relFile ) )
+		{
+			return false;
+		}
+
+		if ( file.FileExists() )
+		{
+			wxRemoveFile( file.GetFullPath() );
+		}
+
+		return doPushOperation( { eRemove, "test " + testName, relFile, wxString{} } );
+	}
+
+	bool LibGit2::commit( wxString const & label )
+	{
+		if ( !m_enabled )
+		{
+			return true;
+		}
+
+		if ( auto database = m_fileSystem->prepareDbCommit() )
+		{
+			updateFile( "Database", *database );
+		}
+
+		return doPushOperation( { eCommit, label, wxString{}, wxString{} } );
+	}
+
+	bool LibGit2::doGetRelativePath( wxFileName const & file
+		, wxString & result )const
+	{
+		auto relFile = file;
+
+		if ( !relFile.MakeRelativeTo( m_rootGitDir.GetFullPath() ) )
+		{
+			wxLogError( wxString() << "LibGit2: " << "Couldn't find relative path from [" << m_rootGitDir << "] to [" << file << "]" );
+			return false;
+		}
+
+		// libgit2 expects '/' separated paths.
+		result = relFile.GetFullPath( wxPATH_UNIX );
+		return true;
+	}
+
+	bool LibGit2::doPushOperation( Operation operation )
+	{
+		auto type = operation.type;
+		{
+			auto lock( makeUniqueLock( m_operationsMutex ) );
+			m_operations.push_back( std::move( operation ) );
+		}
+
+		if ( type > eCommit )
+		{
+			m_modifOperationCount++;
+		}
+		else if ( type == eCommit )
+		{
+			m_modifOperationCount = 0u;
+		}
+
+		if ( m_modifOperationCount >= libgit2::MaxModifsToCommit )
+		{
+			commit( "Intermediate save" );
+		}
+
+		notifyPendingWork();
+		return true;
+	}
+
+	bool LibGit2::doPushFileOperation( OperationType type
+		, wxString const & testName
+		, wxFileName const & file )
+	{
+		if ( !m_enabled )
+		{
+			return true;
+		}
+
+		wxString relFile;
+
+		if ( !doGetRelativePath( file, relFile ) )
+		{
+			return false;
+		}
+
+		return doPushOperation( { type, "test " + testName, relFile, wxString{} } );
+	}
+
+	void LibGit2::doProcess( std::deque< Operation > operations )
+	{
+		// Pick up changes made to the index from outside.
+		libgit2::check( git_index_read( m_index, 0 ), "read index" );
+		bool dirty = false;
+
+		for ( auto & operation : operations )
+		{
+			if ( operation.type == eCommit )
+			{
+				if ( dirty )
+				{
+					dirty = !libgit2::check( git_index_write( m_index ), "write index" );
+				}
+
+				doCommit( operation.name );
+			}
+			else if ( doProcess( operation ) )
+			{
+				dirty = true;
+				doLogModif( { operation.type, operation.name } );
+			}
+		}
+
+		if ( dirty )
+		{
+			libgit2::check( git_index_write( m_index ), "write index" );
+		}
+	}
+
+	bool LibGit2::doProcess( Operation const & operation )
+	{
+		auto path = operation.path.ToUTF8();
+		auto destination = operation.destination.ToUTF8();
+
+		switch ( operation.type )
+		{
+		case eTouch:
+		case eAdd:
+		case eUpdate:
+			return libgit2::check( git_index_add_bypath( m_index, path.data() ), "add " + operation.path );
+		case eMove:
+			return libgit2::check( git_index_remove_bypath( m_index, path.data() ), "remove " + operation.path )
+				&& libgit2::check( git_index_add_bypath( m_index, destination.data() ), "add " + operation.destination );
+		case eRemove:
+			return libgit2::check( git_index_remove_bypath( m_index, path.data() ), "remove " + operation.path );
+		case eMoveFolder:
+			{
+				char * pathspec = destination.data();
+				git_strarray pathspecs{ &pathspec, 1u };
+				return libgit2::check( git_index_remove_directory( m_index, path.data(), 0 ), "remove " + operation.path )
+					&& libgit2::check( git_index_add_all( m_index, &pathspecs, GIT_INDEX_ADD_DEFAULT, nullptr, nullptr ), "add " + operation.destination );
+			}
+		case eRemoveFolder:
+			return libgit2::check( git_index_remove_directory( m_index, path.data(), 0 ), "remove " + operation.path );
+		default:
+			assert( false
+				&& "LibGit2::doProcess - Unsupported OperationType" );
+			return false;
+		}
+	}
+
+	bool LibGit2::doCommit( wxString const & label )
+	{
+		git_oid treeId;
+
+		if ( !libgit2::check( git_index_write_tree( &treeId, m_index ), "write tree" ) )
+		{
+			return false;
+		}
+
+		git_oid parentId;
+		git_commit * parent{};
+
+		if ( git_reference_name_to_id( &parentId, m_repository, "HEAD" ) == 0
+			&& !libgit2::check( git_commit_lookup( &parent, m_repository, &parentId ), "find HEAD commit" ) )
+		{
+			return false;
+		}
+
+		if ( parent
+			&& git_oid_equal( git_commit_tree_id( parent ), &treeId ) )
+		{
+			// Nothing to commit.
+			git_commit_free( parent );
+			return true;
+		}
+
+		git_tree * tree{};
+		git_signature * signature{};
+		git_oid commitId;
+		auto result = libgit2::check( git_tree_lookup( &tree, m_repository, &treeId ), "find tree" )
+			&& libgit2::check( git_signature_default( &signature, m_repository ), "get signature" )
+			&& libgit2::check( git_commit_create_v( &commitId
+					, m_repository
+					, "HEAD"
+					, signature
+					, signature
+					, nullptr
+					, makeCommitMessage( label, m_modifs ).ToUTF8().data()
+					, tree
+					, parent ? 1 : 0
+					, parent )
+				, "commit" );
+
+		if ( result )
+		{
+			wxLogMessage( wxString() << "LibGit2: " << "Committed [" << label << "]" );
+			m_modifs.clear();
+		}
+
+		git_signature_free( signature );
+		git_tree_free( tree );
+		git_commit_free( parent );
+		return result;
+	}
+
+	void LibGit2::doLogModif( Modif const & modif )
+	{
+		if ( modif.type > eCommit )
+		{
+			m_modifs.push_back( modif );
+		}
+
+		if ( modif.type != eTouch )
+		{
+			wxLogMessage( wxString() << "LibGit2: " << getEntryName( modif.type ) << " " << modif.name << "." );
+		}
+	}
+
+	wxString LibGit2::getEntryName( OperationType type )
+	{
+		switch ( type )
+		{
+		case eTouch:
+			return wxString{};
+		case eCommit:
+			return "Commit";
+		case eAdd:
+			return "Added";
+		case eUpdate:
+			return "Updated";
+		case eMove:
+		case eMoveFolder:
+			return "Moved";
+		case eRemove:
+		case eRemoveFolder:
+			return "Removed";
+		default:
+			assert( false
+				&& "LibGit2::getEntryName - Unsupported OperationType" );
+			return "Unknown";
+		}
+	}
+
+	wxString LibGit2::makeCommitMessage( wxString const & label
+		, std::vector< Modif > const & modifs )
+	{
+		wxString result;
+		result << "[Aria] " << label;
+
+		if ( !modifs.empty() )
+		{
+			result << "\n";
+
+			for ( auto & modif : modifs )
+			{
+				result << "\n" << getEntryName( modif.type ) << " " << modif.name << ".";
+			}
+		}
+
+		return result;
+	}
+
+	//*********************************************************************************************
+}
+
+#endif
@@ -0,0 +1,128 @@
+/*
+See LICENSE file in root folder
+*/
+#ifndef ___ARIA_LibGit2FileSystemPlugin_HPP___
+#define ___ARIA_LibGit2FileSystemPlugin_HPP___
+
+#include <AriaLib/FileSystem/FileSystem.hpp>
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <wx/frame.h>
+#include <wx/timer.h>
+
+#include <deque>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+struct git_index;
+struct git_repository;
+
+namespace aria
+{
+	// Git file system plugin working in-process, through libgit2, on a single repository and index.
+	// Files are moved and removed right away, index updates and commits are processed by step().
+	class LibGit2
+		: public FileSystemPlugin
+	{
+	private:
+		enum OperationType
+		{
+			eTouch,
+			eCommit,
+			eAdd,
+			eUpdate,
+			eMove,
+			eRemove,
+			eMoveFolder,
+			eRemoveFolder,
+		};
+
+		struct Operation
+		{
+			OperationType type;
+			// The test name, or the commit label.
+			wxString name;
+			wxString path;
+			wxString destination;
+		};
+
+		struct Modif
+		{
+			OperationType type;
+			wxString name;
+		};
+
+	public:
+		LibGit2( wxFrame * parent
+			, wxWindowID handlerID
+			, FileSystem * fileSystem
+			, wxFileName const & curDir
+			, std::mutex * mutex );
+		~LibGit2()override;
+
+		void initialise()override;
+		void cleanup()override;
+		void step();
+
+		bool moveFolder( wxFileName const & base
+			, wxString const & oldName
+			, wxString const & newName )override;
+		bool removeFolder( wxFileName const & base
+			, wxString const & name )override;
+		bool moveFile( wxString const & testName
+			, wxFileName const & src
+			, wxFileName const & dst )override;
+		bool addFileMod( wxString const & testName
+			, wxFileName const & file )override;
+		bool addFile( wxString const & testName
+			, wxFileName const & file )override;
+		bool updateFile( wxString const & testName
+			, wxFileName const & file )override;
+		bool removeFile( wxString const & testName
+			, wxFileName const & file )override;
+		bool commit( wxString const & label )override;
+
+		bool isEnabled()const override
+		{
+			return m_enabled;
+		}
+
+		bool isRemoving()const override
+		{
+			return m_enabled;
+		}
+
+	private:
+		bool doGetRelativePath( wxFileName const & file
+			, wxString & result )const;
+		bool doPushOperation( Operation operation );
+		bool doPushFileOperation( OperationType type
+			, wxString const & testName
+			, wxFileName const & file );
+		void doProcess( std::deque< Operation > operations );
+		bool doProcess( Operation const & operation );
+		bool doCommit( wxString const & label );
+		void doLogModif( Modif const & modif );
+
+		static wxString getEntryName( OperationType type );
+		static wxString makeCommitMessage( wxString const & label
+			, std::vector< Modif > const & modifs );
+
+	private:
+		wxFrame * m_parent{};
+		FileSystem * m_fileSystem{};
+		wxWindowID m_handlerID{};
+		wxFileName m_rootGitDir;
+		git_repository * m_repository{};
+		git_index * m_index{};
+		bool m_enabled{};
+		// Protects the operations queue, filled by the callers, under the plugin mutex,
+		// and emptied by step(), on the worker thread, which doesn't take the plugin mutex.
+		std::mutex m_operationsMutex;
+		std::deque< Operation > m_operations;
+		std::vector< Modif > m_modifs;
+		uint32_t m_modifOperationCount{};
+		wxTimer * m_timer{};
+	};
+}
+
+#endif
@@ -128,6 +128,8 @@ namespace aria
 		, bool newCategory )
 	{
 		TestTreeModelNode * node = new TestTreeModelNode{ m_root, m_renderer, category, counts };
+		// A new category has no test to load.
+		node->loaded = newCategory;
 		m_categories[category->name] = node;
 
 		if ( m_root )
@@ -151,19 +153,27 @@ namespace aria
 
 		if ( nodeIt != m_categories.end() )
 		{
-			auto node = nodeIt->second;
-			auto counts = node->categoryCounts;
-
+			auto oldNode = nodeIt->second;
 			m_categories.erase( nodeIt );
 			
 			if ( m_root )
 			{
-				m_root->Remove( node );
+				m_root->Remove( oldNode );
 			}
 
-			ItemDeleted( wxDataViewItem{ m_root }, wxDataViewItem{ node } );
+			ItemDeleted( wxDataViewItem{ m_root }, wxDataViewItem{ oldNode } );
+
+			// The loaded tests nodes are moved to the new category node, so they stay indexed.
+			auto node = new TestTreeModelNode{ m_root, m_renderer, category, *oldNode->categoryCounts };
+			node->loaded = oldNode->loaded;
+			std::swap( node->GetChildren(), oldNode->GetChildren() );
 
-			node = new TestTreeModelNode{ m_root, m_renderer, category, *counts };
+			for ( auto child : node->GetChildren() )
+			{
+				child->SetParent( node );
+			}
+
+			delete oldNode;
 			m_categories[category->name] = node;
 			
 			if ( m_root )
@@ -183,6 +193,7 @@ namespace aria
 		{
 			auto node = nodeIt->second;
 			m_categories.erase( nodeIt );
+			doUnindexChildren( *node );
 
 			if ( m_root )
 			{
@@ -200,6 +211,7 @@ namespace aria
 		wxASSERT( m_categories.end() != it );
 		TestTreeModelNode * node = new TestTreeModelNode{ it->second, test };
 		it->second->Append( node );
+		m_tests[test.getTestId()] = node;
 
 		if ( newTest )
 		{
@@ -211,39 +223,62 @@ namespace aria
 
 	TestTreeModelNode * TestTreeModel::getTestNode( DatabaseTest const & test )const
 	{
-		TestTreeModelNode * result{};
-		auto it = m_categories.begin();
-
-		while ( !result && it != m_categories.end() )
-		{
-			auto nodeIt = std::find_if( it->second->GetChildren().begin()
-				, it->second->GetChildren().end()
-				, [&test]( TestTreeModelNode * lookup )
-				{
-					return lookup->test
-						&& lookup->test->getTestId() == test.getTestId();
-				} );
+		auto it = m_tests.find( test.getTestId() );
+		return it == m_tests.end()
+			? nullptr
+			: it->second;
+	}
 
-			if ( nodeIt != it->second->GetChildren().end() )
-			{
-				result = *nodeIt;
-			}
+	void TestTreeModel::removeTest( DatabaseTest const & test )
+	{
+		auto testIt = m_tests.find( test.getTestId() );
 
-			++it;
+		if ( testIt == m_tests.end() )
+		{
+			// The test's category hasn't been loaded.
+			return;
 		}
 
-		return result;
-	}
+		auto node = testIt->second;
+		m_tests.erase( testIt );
 
-	void TestTreeModel::removeTest( DatabaseTest const & test )
-	{
-		auto node = getTestNode( test );
 		auto it = m_categories.find( node->category->name );
 		wxASSERT( m_categories.end() != it );
 		it->second->Remove( node );
 		ItemDeleted( wxDataViewItem{ it->second }, wxDataViewItem{ node } );
 	}
 
+	void TestTreeModel::setCategoryLoader( CategoryLoader loader )
+	{
+		m_loader = std::move( loader );
+	}
+
+	bool TestTreeModel::isLoaded( Category category )const
+	{
+		auto it = m_categories.find( category->name );
+		return it == m_categories.end()
+			|| it->second->loaded;
+	}
+
+	void TestTreeModel::loadCategory( Category category )
+	{
+		auto it = m_categories.find( category->name );
+
+		if ( it == m_categories.end()
+			|| it->second->loaded )
+		{
+			return;
+		}
+
+		wxDataViewItemArray added;
+		doLoadCategory( *it->second, &added );
+
+		if ( !added.empty() )
+		{
+			ItemsAdded( wxDataViewItem{ it->second }, added );
+		}
+	}
+
 	void TestTreeModel::expandRoots( wxDataViewCtrl * view )
 	{
 		view->Expand( wxDataViewItem{ m_root } );
@@ -332,6 +367,15 @@ namespace aria
 				//       thus removing the node from it doesn't result in freeing it
 				node->GetParent()->Remove( node );
 
+				if ( node->test )
+				{
+					m_tests.erase( node->test->getTestId() );
+				}
+				else
+				{
+					doUnindexChildren( *node );
+				}
+
 				// free the node
 				delete node;
 
@@ -574,6 +618,12 @@ namespace aria
 		}
 		else
 		{
+			if ( !node->loaded && isCategoryNode( *node ) )
+			{
+				// The control is querying the children, it mustn't be notified of their addition.
+				doLoadCategory( *node, nullptr );
+			}
+
 			if ( node->GetChildCount() > 0 )
 			{
 				auto count = static_cast< unsigned int >( node->GetChildCount() );
@@ -596,5 +646,39 @@ namespace aria
 		return false;
 	}
 
+	void TestTreeModel::doLoadCategory( TestTreeModelNode & node
+		, wxDataViewItemArray * added )const
+	{
+		node.loaded = true;
+
+		if ( !m_loader )
+		{
+			return;
+		}
+
+		for ( auto test : m_loader( node.category ) )
+		{
+			auto child = new TestTreeModelNode{ &node, *test };
+			node.Append( child );
+			m_tests[test->getTestId()] = child;
+
+			if ( added )
+			{
+				added->Add( wxDataViewItem{ child } );
+			}
+		}
+	}
+
+	void TestTreeModel::doUnindexChildren( TestTreeModelNode & node )
+	{
+		for ( auto child : node.GetChildren() )
+		{
+			if ( child->test )
+			{
+				m_tests.erase( child->test->getTestId() );
+			}
+		}
+	}
+
 	//*********************************************************************************************
 }
@@ -8,6 +8,9 @@ See LICENSE file in root folder
 
 #include <AriaLib/BeginExternHeaderGuard.hpp>
 #include <wx/dataview.h>
+
+#include <functional>
+#include <unordered_map>
 #include <AriaLib/EndExternHeaderGuard.hpp>
 
 namespace aria
@@ -30,6 +33,8 @@ namespace aria
 			eRunTime,
 			eCount,
 		};
+		// Loads the tests of a category, the first time its children are requested.
+		using CategoryLoader = std::function< DatabaseTestArray( Category ) >;
 
 	public:
 		TestTreeModel( Renderer renderer
@@ -46,6 +51,9 @@ namespace aria
 			, bool newTest = false );
 		TestTreeModelNode * getTestNode( DatabaseTest const & test )const;
 		void removeTest( DatabaseTest const & test );
+		void setCategoryLoader( CategoryLoader loader );
+		bool isLoaded( Category category )const;
+		void loadCategory( Category category );
 		void expandRoots( wxDataViewCtrl * view );
 		void instantiate( wxDataViewCtrl * view );
 		void resize( wxDataViewCtrl * view
@@ -84,10 +92,18 @@ namespace aria
 			, wxDataViewItemArray & array )const override;
 		bool HasContainerColumns( const wxDataViewItem & item )const override;
 
+	private:
+		void doLoadCategory( TestTreeModelNode & node
+			, wxDataViewItemArray * added )const;
+		void doUnindexChildren( TestTreeModelNode & node );
+
 	private:
 		Renderer m_renderer;
 		TestTreeModelNode * m_root;
 		std::map< std::string, TestTreeModelNode * > m_categories;
+		// The test nodes, by test ID, filled when categories are loaded.
+		mutable std::unordered_map< int32_t, TestTreeModelNode * > m_tests;
+		CategoryLoader m_loader;
 	};
 }
 
@@ -35,6 +35,11 @@ namespace aria
 			return m_parent;
 		}
 
+		void SetParent( TestTreeModelNode * parent )
+		{
+			m_parent = parent;
+		}
+
 		TestTreeModelNodePtrArray & GetChildren()
 		{
 			return m_children;
@@ -73,6 +78,8 @@ namespace aria
 		AllTestsCounts const * allCounts{};
 		RendererTestsCounts const * rendererCounts{};
 		TestsCounts const * categoryCounts{};
+		// For category nodes, tells if the test nodes have been created.
+		bool loaded{};
 
 	private:
 		bool m_container{};
@@ -7,6 +7,7 @@
 #include "Panels/LayeredPanel.hpp"
 #include "Panels/TestPanel.hpp"
 
+#include <AriaLib/Progress.hpp>
 #include <AriaLib/TestsCounts.hpp>
 #include <AriaLib/Aui/AuiDockArt.hpp>
 #include <AriaLib/Database/DatabaseTest.hpp>
@@ -14,8 +15,8 @@
 
 #include <AriaLib/BeginExternHeaderGuard.hpp>
 #include <wx/clipbrd.h>
-#include <wx/progdlg.h>
 #include <wx/stattext.h>
+#include <wx/timer.h>
 #include <AriaLib/EndExternHeaderGuard.hpp>
 
 namespace aria
@@ -27,8 +28,12 @@ namespace aria
 		enum ID
 		{
 			eID_GRID,
+			eID_TIMER_REFRESH,
 		};
 
+		// 30 refreshes per second at most.
+		static int constexpr RefreshPeriod = 33;
+
 		struct TestView
 		{
 			enum Type : size_t
@@ -52,6 +57,7 @@ namespace aria
 
 	RendererPage::RendererPage( Plugin const & plugin
 		, Renderer renderer
+		, TestMap const & tests
 		, RendererTestRuns & runs
 		, RendererTestsCounts & counts
 		, wxWindow * parent
@@ -63,16 +69,27 @@ namespace aria
 		, m_renderer{ renderer }
 		, m_menus{ menus }
 		, m_auiManager{ this, wxAUI_MGR_ALLOW_FLOATING | wxAUI_MGR_TRANSPARENT_HINT | wxAUI_MGR_HINT_FADE | wxAUI_MGR_VENETIAN_BLINDS_HINT | wxAUI_MGR_LIVE_RESIZE }
+		, m_tests{ tests }
 		, m_runs{ runs }
 		, m_counts{ counts }
 		, m_selectionCounts{ m_plugin }
 		, m_model{ new TestTreeModel{ renderer, counts } }
+		, m_refreshTimer{ new wxTimer{ this, rendpage::eID_TIMER_REFRESH } }
 	{
+		m_model->setCategoryLoader( [this]( Category category )
+			{
+				return doLoadCategory( category );
+			} );
 		doInitLayout( frame );
+		Bind( wxEVT_TIMER
+			, &RendererPage::onRefreshTimer
+			, this
+			, rendpage::eID_TIMER_REFRESH );
 	}
 
 	RendererPage::~RendererPage()
 	{
+		m_refreshTimer->Stop();
 		m_auiManager.UnInit();
 	}
 
@@ -94,41 +111,50 @@ namespace aria
 	}
 
 	void RendererPage::listLatestRuns( TestDatabase & database
-		, TestMap const & tests
 		, AllTestsCounts & counts
-		, wxProgressDialog & progress
+		, Progress & progress
 		, int & index )
+	{
+		// The tests are loaded when their category is expanded, only their counts are needed here.
+		RendererTestsCounts loaded{ m_plugin };
+
+		for ( auto & category : m_tests )
+		{
+			loaded.addCategory( category.first, category.second );
+		}
+
+		database.countLatestRuns( m_renderer
+			, m_tests
+			, loaded );
+#if defined( _WIN32 )
+		progress.update( index++
+			, _( "Counting tests runs" )
+			+ wxT( "\n" ) + m_renderer->name );
+		progress.fit();
+#else
+		progress.update( index++ );
+#endif
+		addLatestCounts( database, counts, loaded );
+	}
+
+	void RendererPage::addLatestCounts( TestDatabase const & database
+		, AllTestsCounts & counts
+		, RendererTestsCounts & loaded )
 	{
 		for ( auto & category : database.getCategories() )
 		{
-			auto testsIt = tests.find( category.second.get() );
+			auto testsIt = m_tests.find( category.second.get() );
 			auto & catCounts = counts.addCategory( m_renderer
 				, category.second.get()
 				, testsIt->second );
-			m_model->addCategory( category.second.get(), catCounts );
-		}
+			auto loadedIt = loaded.getCategories().find( category.second.get() );
 
-		database.listLatestRuns( m_renderer
-			, tests
-			, m_runs
-			, progress
-			, index );
+			if ( loadedIt != loaded.getCategories().end() )
+			{
+				catCounts.add( loadedIt->second );
+			}
 
-		for ( auto & run : m_runs )
-		{
-			auto category = run.getCategory();
-			auto & catCounts = counts.getCategory( m_renderer
-				, category );
-			catCounts.addTest( run );
-			( void )m_model->addTest( run );
-#if defined( _WIN32 )
-			progress.Update( index++
-				, _( "Filling tests list" )
-				+ wxT( "\n" ) + getProgressDetails( run ) );
-			progress.Fit();
-#else
-			progress.Update( index++ );
-#endif
+			m_model->addCategory( category.second.get(), catCounts );
 		}
 
 		auto & rendCounts = counts.getRenderer( m_renderer );
@@ -140,22 +166,33 @@ namespace aria
 		m_auiManager.Update();
 	}
 
+	void RendererPage::loadCategory( Category category )
+	{
+		m_model->loadCategory( category );
+	}
+
+	void RendererPage::loadAllCategories()
+	{
+		for ( auto & category : m_tests )
+		{
+			m_model->loadCategory( category.first );
+		}
+	}
+
 	void RendererPage::updateTest( TestTreeModelNode * node )
 	{
-		m_model->ItemChanged( wxDataViewItem{ node } );
-		m_categoryView->refresh();
-		m_view->Refresh();
+		doMarkDirty( wxDataViewItem{ node } );
 	}
 
 	std::vector< wxDataViewItem > RendererPage::listRendererTests( Renderer renderer
-		, FilterFunc filter )const
+		, FilterFunc filter )
 	{
 		std::vector< wxDataViewItem > result;
 		doListRendererTests( renderer, filter, result );
 		return result;
 	}
 
-	std::vector< wxDataViewItem > RendererPage::listRenderersTests( FilterFunc filter )const
+	std::vector< wxDataViewItem > RendererPage::listRenderersTests( FilterFunc filter )
 	{
 		std::vector< wxDataViewItem > result;
 
@@ -173,14 +210,14 @@ namespace aria
 	}
 
 	std::vector< wxDataViewItem > RendererPage::listCategoryTests( Category category
-		, FilterFunc filter )const
+		, FilterFunc filter )
 	{
 		std::vector< wxDataViewItem > result;
 		doListCategoryTests( category, filter, result );
 		return result;
 	}
 
-	std::vector< wxDataViewItem > RendererPage::listCategoriesTests( FilterFunc filter )const
+	std::vector< wxDataViewItem > RendererPage::listCategoriesTests( FilterFunc filter )
 	{
 		std::vector< wxDataViewItem > result;
 
@@ -291,12 +328,12 @@ namespace aria
 		if ( !m_selected.items.empty() )
 		{
 			m_mainFrame->pushDbJob( "setTestsReferences"
-				, [this, &counts]()
+				, [this, &counts, items = m_selected.items]()
 				{
 					using wxAsyncUpdateTestViewCallback = std::function< void() >;
 					using wxAsyncUpdateTestView = wxAsyncMethodCallEventFunctor< wxAsyncUpdateTestViewCallback >;
 
-					for ( auto & item : m_selected.items )
+					for ( auto & item : items )
 					{
 						auto node = static_cast< TestTreeModelNode * >( item.GetID() );
 
@@ -321,9 +358,9 @@ namespace aria
 		if ( !m_selected.items.empty() )
 		{
 			m_mainFrame->pushDbJob( "ignoreTestsResult"
-				, [this, ignore]()
+				, [this, ignore, items = m_selected.items]()
 				{
-					for ( auto & item : m_selected.items )
+					for ( auto & item : items )
 					{
 						auto node = static_cast< TestTreeModelNode * >( item.GetID() );
 
@@ -340,14 +377,54 @@ namespace aria
 		}
 	}
 
+	void RendererPage::updateUnloadedOutdated( TestDatabase & database )
+	{
+		// The unloaded categories have no runs to check against the new engine date,
+		// their outdated counts are taken from the runs statuses aggregates again.
+		RendererTestsCounts counted{ m_plugin };
+
+		for ( auto & category : m_tests )
+		{
+			if ( !m_model->isLoaded( category.first ) )
+			{
+				counted.addCategory( category.first, category.second );
+			}
+		}
+
+		if ( counted.getCategories().empty() )
+		{
+			return;
+		}
+
+		database.countLatestRuns( m_renderer
+			, m_tests
+			, counted );
+
+		for ( auto & category : counted.getCategories() )
+		{
+			auto & catCounts = m_counts.getCounts( category.first );
+			auto outdated = category.second.getOutdatedValue();
+			auto current = catCounts.getOutdatedValue();
+
+			if ( outdated > current )
+			{
+				catCounts.addOutdated( outdated - current );
+			}
+			else if ( outdated < current )
+			{
+				catCounts.removeOutdated( current - outdated );
+			}
+		}
+	}
+
 	void RendererPage::updateTestsEngineDate()
 	{
 		if ( !m_selected.items.empty() )
 		{
 			m_mainFrame->pushDbJob( "updateTestsEngineDate"
-				, [this]()
+				, [this, items = m_selected.items]()
 				{
-					for ( auto & item : m_selected.items )
+					for ( auto & item : items )
 					{
 						auto node = static_cast< TestTreeModelNode * >( item.GetID() );
 
@@ -366,9 +443,9 @@ namespace aria
 		if ( !m_selected.items.empty() )
 		{
 			m_mainFrame->pushDbJob( "updateTestsSceneDate"
-				, [this]()
+				, [this, items = m_selected.items]()
 				{
-					for ( auto & item : m_selected.items )
+					for ( auto & item : items )
 					{
 						auto node = static_cast< TestTreeModelNode * >( item.GetID() );
 
@@ -397,6 +474,8 @@ namespace aria
 
 	void RendererPage::removeTest( DatabaseTest const & dbTest )
 	{
+		// The pending changes may reference the removed node.
+		doFlushRefresh();
 		m_model->removeTest( dbTest );
 	}
 
@@ -404,28 +483,44 @@ namespace aria
 		, AllTestsCounts & counts )
 	{
 		wxDataViewItem testItem{ getTestNode( test ) };
-		m_model->ItemChanged( testItem );
+
+		if ( !testItem.IsOk() )
+		{
+			return;
+		}
+
+		doMarkDirty( testItem );
 		wxDataViewItem categoryItem{ m_model->GetParent( testItem ) };
-		m_model->ItemChanged( categoryItem );
-		wxDataViewItem rendererItem{ m_model->GetParent( categoryItem ) };
-		m_model->ItemChanged( rendererItem );
+		doMarkDirty( categoryItem );
+		doMarkDirty( m_model->GetParent( categoryItem ) );
 
 		if ( m_detailViews->isLayerShown( rendpage::TestView::eTest )
 			&& m_testView->getTest() == &test )
 		{
-			m_testView->refresh();
+			m_dirtyTestView = true;
 		}
 	}
 
 	void RendererPage::preChangeTestName( Test const & test
 		, wxString const & newName )
 	{
+		if ( !m_model->isLoaded( test.category ) )
+		{
+			// The test will be loaded with its new name.
+			return;
+		}
+
 		preChangeTestName( m_runs.getTest( test.id ), newName );
 	}
 
 	void RendererPage::postChangeTestName( Test const & test
 		, wxString const & oldName )
 	{
+		if ( !m_model->isLoaded( test.category ) )
+		{
+			return;
+		}
+
 		postChangeTestName( m_runs.getTest( test.id ), oldName );
 	}
 
@@ -443,12 +538,14 @@ namespace aria
 
 	void RendererPage::removeCategory( Category category )
 	{
+		doFlushRefresh();
 		m_model->removeCategory( category );
 	}
 
 	void RendererPage::postChangeCategoryName( Category category
 		, wxString const & oldName )
 	{
+		doFlushRefresh();
 		m_model->renameCategory( category, oldName );
 	}
 
@@ -582,10 +679,41 @@ namespace aria
 		m_auiManager.Update();
 	}
 
+	DatabaseTestArray RendererPage::doLoadCategory( Category category )
+	{
+		auto testsIt = m_tests.find( category );
+
+		if ( testsIt == m_tests.end() )
+		{
+			return {};
+		}
+
+		// The counts came from the runs statuses aggregates, from now on they follow the loaded tests.
+		auto & catCounts = m_counts.getCounts( category );
+		catCounts.clear();
+		auto result = m_mainFrame->getDatabase().listLatestRuns( m_renderer
+			, category
+			, testsIt->second
+			, m_runs );
+
+		for ( auto run : result )
+		{
+			catCounts.addTest( *run );
+		}
+
+		CallAfter( [this]()
+			{
+				m_categoryView->refresh();
+			} );
+		return result;
+	}
+
 	void RendererPage::doListCategoryTests( Category category
 		, FilterFunc filter
-		, std::vector< wxDataViewItem > & result )const
+		, std::vector< wxDataViewItem > & result )
 	{
+		loadCategory( category );
+
 		for ( auto & run : m_runs )
 		{
 			if ( run.getCategory() == category
@@ -598,8 +726,10 @@ namespace aria
 
 	void RendererPage::doListRendererTests( Renderer renderer
 		, FilterFunc filter
-		, std::vector< wxDataViewItem > & result )const
+		, std::vector< wxDataViewItem > & result )
 	{
+		loadAllCategories();
+
 		for ( auto & run : m_runs )
 		{
 			if ( filter( run ) )
@@ -609,6 +739,55 @@ namespace aria
 		}
 	}
 
+	void RendererPage::doMarkDirty( wxDataViewItem const & item )
+	{
+		if ( !item.IsOk() )
+		{
+			return;
+		}
+
+		m_dirtyNodes.insert( static_cast< TestTreeModelNode * >( item.GetID() ) );
+
+		if ( !m_refreshTimer->IsRunning() )
+		{
+			m_refreshTimer->StartOnce( rendpage::RefreshPeriod );
+		}
+	}
+
+	void RendererPage::doFlushRefresh()
+	{
+		m_refreshTimer->Stop();
+
+		if ( m_dirtyNodes.empty() && !m_dirtyTestView )
+		{
+			return;
+		}
+
+		wxDataViewItemArray items;
+
+		for ( auto node : m_dirtyNodes )
+		{
+			items.Add( wxDataViewItem{ node } );
+		}
+
+		m_dirtyNodes.clear();
+
+		if ( !items.empty() )
+		{
+			m_model->ItemsChanged( items );
+		}
+
+		if ( m_dirtyTestView
+			&& m_detailViews->isLayerShown( rendpage::TestView::eTest ) )
+		{
+			m_testView->refresh();
+		}
+
+		m_dirtyTestView = false;
+		m_categoryView->refresh();
+		m_view->Refresh();
+	}
+
 	void RendererPage::onSelectionChange( wxDataViewEvent & evt )
 	{
 		m_selected.allTests = true;
@@ -805,5 +984,10 @@ namespace aria
 		}
 	}
 
+	void RendererPage::onRefreshTimer( wxTimerEvent & evt )
+	{
+		doFlushRefresh();
+	}
+
 	//*********************************************************************************************
 }
@@ -15,10 +15,10 @@ See LICENSE file in root folder
 
 #include <functional>
 #include <map>
+#include <set>
 #include <AriaLib/EndExternHeaderGuard.hpp>
 
 class wxMenu;
-class wxProgressDialog;
 class wxStaticText;
 class wxString;
 
@@ -45,6 +45,7 @@ namespace aria
 	public:
 		RendererPage( Plugin const & plugin
 			, Renderer renderer
+			, TestMap const & tests
 			, RendererTestRuns & runs
 			, RendererTestsCounts & counts
 			, wxWindow * parent
@@ -56,17 +57,22 @@ namespace aria
 		void refreshView()const;
 		void resizeModel( wxSize const & size );
 		void listLatestRuns( TestDatabase & database
-			, TestMap const & tests
 			, AllTestsCounts & counts
-			, wxProgressDialog & progress
+			, Progress & progress
 			, int & index );
+		void addLatestCounts( TestDatabase const & database
+			, AllTestsCounts & counts
+			, RendererTestsCounts & loaded );
+		void updateUnloadedOutdated( TestDatabase & database );
+		void loadCategory( Category category );
+		void loadAllCategories();
 		void updateTest( TestTreeModelNode * node );
 		std::vector< wxDataViewItem > listRendererTests( Renderer renderer
-			, FilterFunc filter )const;
-		std::vector< wxDataViewItem > listRenderersTests( FilterFunc filter )const;
+			, FilterFunc filter );
+		std::vector< wxDataViewItem > listRenderersTests( FilterFunc filter );
 		std::vector< wxDataViewItem > listCategoryTests( Category category
-			, FilterFunc filter )const;
-		std::vector< wxDataViewItem > listCategoriesTests( FilterFunc filter )const;
+			, FilterFunc filter );
+		std::vector< wxDataViewItem > listCategoriesTests( FilterFunc filter );
 		std::vector< wxDataViewItem > listSelectedTests()const;
 		std::vector< wxDataViewItem > listSelectedCategories()const;
 		void copyTestFileName()const;
@@ -100,14 +106,18 @@ namespace aria
 
 	private:
 		void doInitLayout( wxWindow * frame );
+		DatabaseTestArray doLoadCategory( Category category );
 		void doListCategoryTests( Category category
 			, FilterFunc filter
-			, std::vector< wxDataViewItem > & result )const;
+			, std::vector< wxDataViewItem > & result );
 		void doListRendererTests( Renderer renderer
 			, FilterFunc filter
-			, std::vector< wxDataViewItem > & result )const;
+			, std::vector< wxDataViewItem > & result );
+		void doMarkDirty( wxDataViewItem const & item );
+		void doFlushRefresh();
 		void onSelectionChange( wxDataViewEvent & evt );
 		void onItemContextMenu( wxDataViewEvent & evt );
+		void onRefreshTimer( wxTimerEvent & evt );
 
 	private:
 		TestsMainPanel * m_mainFrame;
@@ -115,6 +125,7 @@ namespace aria
 		Renderer m_renderer;
 		Menus const & m_menus;
 		wxAuiManager m_auiManager;
+		TestMap const & m_tests;
 		RendererTestRuns & m_runs;
 		RendererTestsCounts & m_counts;
 		TestsCounts m_selectionCounts;
@@ -126,6 +137,10 @@ namespace aria
 		TestPanel * m_testView{};
 		CategoryPanel * m_categoryView{};
 		Selection m_selected;
+		// The changed nodes, sent to the view in one batch, at most once per refresh period.
+		std::set< TestTreeModelNode * > m_dirtyNodes;
+		bool m_dirtyTestView{};
+		wxTimer * m_refreshTimer{};
 	};
 }
 
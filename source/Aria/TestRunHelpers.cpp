@@ -0,0 +1,152 @@
+#include "TestRunHelpers.hpp"
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <wx/process.h>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria
+{
+	//*********************************************************************************************
+
+	namespace testrun
+	{
+		static wxFileName getTestFile( Plugin const & plugin
+			, DatabaseTest const & test )
+		{
+			return plugin.config.test / test.getCategory()->name / plugin.getTestName( *test );
+		}
+
+		static TestStatus getStatus( DiffResult result )
+		{
+			switch ( result )
+			{
+			case DiffResult::eNegligible:
+				return TestStatus::eNegligible;
+			case DiffResult::eAcceptable:
+				return TestStatus::eAcceptable;
+			case DiffResult::eUnacceptable:
+				return TestStatus::eUnacceptable;
+			default:
+				// The run didn't produce its output.
+				return TestStatus::eCrashed;
+			}
+		}
+
+		DiffOptions getDiffOptions( Plugin const & plugin
+			, DatabaseTest const & test )
+		{
+			DiffOptions result;
+			auto file = getTestFile( plugin, test );
+			result.input = file.GetPath() / ( file.GetName() + wxT( "_ref.png" ) );
+			result.outputs.emplace_back( file.GetPath() / wxT( "Compare" ) / ( file.GetName() + wxT( "_" ) + test.getRenderer()->name + wxT( ".png" ) ) );
+			result.resultCache = plugin.config.database.GetPath() / ( plugin.config.database.GetName() + wxT( ".diffcache" ) );
+			return result;
+		}
+
+		wxFileName getTimesFile( Plugin const & plugin
+			, DatabaseTest const & test )
+		{
+			auto file = getTestFile( plugin, test );
+			return file.GetPath() / wxT( "Compare" ) / ( file.GetName() + wxT( "_" ) + test.getRenderer()->name + wxT( ".times" ) );
+		}
+
+		void queueNewRun( DatabaseTest & test
+			, TestTimes const & times
+			, DiffWorkerPool::Result const & result )
+		{
+			if ( !result.error.empty() )
+			{
+				wxLogWarning( wxString() << "Test result comparison not possible: " << result.error );
+				test.queueNewRun( TestStatus::eUnprocessed
+					, wxDateTime::Now()
+					, times );
+				return;
+			}
+
+			// Only one output per run.
+			auto status = getStatus( result.results.front() );
+			test.queueNewRun( status
+				, ( status == TestStatus::eCrashed
+					? wxDateTime::Now()
+					: getFileDate( result.files.front() ) )
+				, times );
+		}
+
+		void killIfTimedOut( long pid
+			, std::chrono::steady_clock::time_point start
+			, std::chrono::steady_clock::time_point now
+			, wxString const & testName )
+		{
+			if ( now - start < timeout
+				|| !wxProcess::Exists( int( pid ) ) )
+			{
+				return;
+			}
+
+			wxLogWarning( wxString{} << "Test " << testName << " timed out, killing it." );
+			auto res = wxProcess::Kill( int( pid ), wxSIGKILL );
+
+			switch ( res )
+			{
+			case wxKILL_OK:
+				break;
+			case wxKILL_BAD_SIGNAL:
+				wxLogError( "Couldn't kill process: bad signal." );
+				break;
+			case wxKILL_ACCESS_DENIED:
+				wxLogError( "Couldn't kill process: access denied." );
+				break;
+			case wxKILL_NO_PROCESS:
+				wxLogError( "Couldn't kill process: no process." );
+				break;
+			case wxKILL_ERROR:
+				wxLogError( "Couldn't kill process: error." );
+				break;
+			default:
+				wxLogError( wxString{ wxT( "Couldn't kill process: unknown error: " ) } << res );
+				break;
+			}
+		}
+	}
+
+	//*********************************************************************************************
+
+	RunsFlusher::RunsFlusher( wxEvtHandler & handler
+		, TestDatabase & database )
+		: m_handler{ handler }
+		, m_database{ database }
+	{
+	}
+
+	void RunsFlusher::queue()
+	{
+		if ( m_queued )
+		{
+			return;
+		}
+
+		// The runs ended during the same event loop iteration are inserted together.
+		m_queued = true;
+		m_handler.CallAfter( [this]()
+			{
+				m_queued = false;
+				flush();
+			} );
+	}
+
+	bool RunsFlusher::flush()
+	{
+		try
+		{
+			m_database.flushRuns();
+			return true;
+		}
+		catch ( std::exception & exc )
+		{
+			wxLogError( wxString() << "Couldn't insert the tests runs: " << exc.what() );
+			return false;
+		}
+	}
+
+	//*********************************************************************************************
+}
@@ -0,0 +1,64 @@
+/*
+See LICENSE file in root folder
+*/
+#ifndef ___ARIA_TestRunHelpers_HPP___
+#define ___ARIA_TestRunHelpers_HPP___
+
+#include "DiffWorkerPool.hpp"
+
+#include <AriaLib/Plugin.hpp>
+#include <AriaLib/Database/DatabaseTest.hpp>
+#include <AriaLib/Database/TestDatabase.hpp>
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <wx/event.h>
+
+#include <chrono>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria
+{
+	// The tests runs handling shared by Aria and AriaCli.
+	namespace testrun
+	{
+		// Wait maximum 10 mins for a test run.
+		static auto constexpr timeout = std::chrono::minutes{ 10 };
+		// Running tests timeouts are checked every second.
+		static int constexpr timerKillPeriod = 1000;
+
+		// The comparison of the test run output to its reference.
+		DiffOptions getDiffOptions( Plugin const & plugin
+			, DatabaseTest const & test );
+		// The file holding the times of the test run.
+		wxFileName getTimesFile( Plugin const & plugin
+			, DatabaseTest const & test );
+		// Queues the new run of the test, with the status resulting from its output comparison.
+		void queueNewRun( DatabaseTest & test
+			, TestTimes const & times
+			, DiffWorkerPool::Result const & result );
+		// Kills the run process if it has exceeded the timeout.
+		void killIfTimedOut( long pid
+			, std::chrono::steady_clock::time_point start
+			, std::chrono::steady_clock::time_point now
+			, wxString const & testName );
+	}
+
+	// Inserts the runs queued during an event loop iteration together, at its end.
+	class RunsFlusher
+	{
+	public:
+		RunsFlusher( wxEvtHandler & handler
+			, TestDatabase & database );
+
+		void queue();
+		// Inserts the queued runs right away.
+		bool flush();
+
+	private:
+		wxEvtHandler & m_handler;
+		TestDatabase & m_database;
+		bool m_queued{};
+	};
+}
+
+#endif
@@ -2,9 +2,11 @@
 
 #include "DiffImage.hpp"
 #include "ConfigurationDialog.hpp"
+#include "DialogProgress.hpp"
 #include "MainFrame.hpp"
 #include "RendererPage.hpp"
 #include "FileSystem/GitFileSystemPlugin.hpp"
+#include "FileSystem/LibGit2FileSystemPlugin.hpp"
 #include "Model/TestsModel/TestTreeModel.hpp"
 #include "Model/TestsModel/TestTreeModelNode.hpp"
 #include "Panels/CategoryPanel.hpp"
@@ -26,12 +28,12 @@
 #include <wx/gauge.h>
 #include <wx/menu.h>
 #include <wx/msgdlg.h>
-#include <wx/progdlg.h>
 #include <wx/sizer.h>
 #include <wx/stattext.h>
 #include <wx/textdlg.h>
 
 #include <fstream>
+#include <set>
 #include <AriaLib/EndExternHeaderGuard.hpp>
 
 namespace aria
@@ -40,9 +42,6 @@ namespace aria
 
 	namespace tests
 	{
-		// Wait maximum 10 mins for a test run.
-		static int constexpr timerKillTimeout = 1000 * 60 * 10;
-
 		static Category selectCategory( wxWindow * parent
 			, TestDatabase const & database )
 		{
@@ -84,66 +83,11 @@ namespace aria
 			, wxFileName const & curDir )
 		{
 			FileSystemPtr result = std::make_unique< FileSystem >();
+#if ARIA_LibGit2Support
+			result->registerThreadedPlugin< LibGit2 >( parent, handlerID, result.get(), curDir );
+#else
 			result->registerThreadedPlugin< Git >( parent, handlerID, result.get(), curDir );
-			return result;
-		}
-
-		static TestTimes processTestOutputTimes( TestDatabase & database
-			, wxFileName const & timesFilePath )
-		{
-			TestTimes result{};
-
-			if ( timesFilePath.FileExists() )
-			{
-				{
-					std::ifstream file{ timesFilePath.GetFullPath().ToStdString() };
-
-					if ( file.is_open() )
-					{
-						std::string line;
-						auto lineIndex = 0u;
-						uint32_t t, a, l;
-						std::string platform, cpu, gpu;
-
-						while ( std::getline( file, line ) && lineIndex < 4u )
-						{
-							switch ( lineIndex )
-							{
-							case 0u:
-								platform = line;
-								break;
-							case 1u:
-								cpu = line;
-								break;
-							case 2u:
-								gpu = line;
-								break;
-							case 3u:
-								{
-									std::stringstream stream{ line };
-									stream >> t >> a >> l;
-								}
-								break;
-							default:
-								break;
-							}
-
-							++lineIndex;
-						}
-
-						result.host = database.getHost( platform, cpu, gpu );
-						result.total = Microseconds{ t };
-						result.avg = Microseconds{ a };
-						result.last = Microseconds{ l };
-					}
-				}
-				wxRemoveFile( timesFilePath.GetFullPath() );
-			}
-			else
-			{
-				result.host = database.getHost( "Unknown", "Unknown", "Unknown" );
-			}
-
+#endif
 			return result;
 		}
 	}
@@ -165,35 +109,85 @@ namespace aria
 
 	//*********************************************************************************************
 
-	TestNode TestsMainPanel::RunningTest::current()
-	{
-		return running;
-	}
-
 	void TestsMainPanel::RunningTest::push( TestNode node )
 	{
 		pending.emplace_back( std::move( node ) );
 	}
 
-	TestNode TestsMainPanel::RunningTest::next()
+	TestNode TestsMainPanel::RunningTest::next( uint32_t maxPerRenderer )
 	{
-		if ( !pending.empty() )
+		// The same test can't run twice simultaneously, since both runs would write the same output files.
+		auto it = std::find_if( pending.begin()
+			, pending.end()
+			, [this, maxPerRenderer]( TestNode const & lookup )
+			{
+				return !isRunning( *lookup.test )
+					&& countRunning( lookup.test->getRenderer() ) < maxPerRenderer;
+			} );
+
+		if ( it == pending.end() )
 		{
-			running = *pending.begin();
-			running.status = TestStatus::eRunning_0;
-			pending.erase( pending.begin() );
+			return {};
 		}
-		else
+
+		auto result = *it;
+		pending.erase( it );
+		return result;
+	}
+
+	void TestsMainPanel::RunningTest::start( long pid
+		, TestNode node
+		, std::unique_ptr< wxProcess > process )
+	{
+		running.emplace( pid
+			, Running{ std::move( process )
+				, std::move( node )
+				, std::chrono::steady_clock::now() } );
+	}
+
+	TestsMainPanel::RunningTest::Running * TestsMainPanel::RunningTest::find( long pid )
+	{
+		auto it = running.find( pid );
+		return it == running.end()
+			? nullptr
+			: &it->second;
+	}
+
+	TestNode TestsMainPanel::RunningTest::end( long pid )
+	{
+		auto it = running.find( pid );
+
+		if ( it == running.end() )
 		{
-			running = {};
+			return {};
 		}
 
-		return running;
+		auto result = it->second.node;
+		running.erase( it );
+		return result;
+	}
+
+	void TestsMainPanel::RunningTest::compare( TestNode node )
+	{
+		comparing.emplace_back( std::move( node ) );
 	}
 
-	void TestsMainPanel::RunningTest::end()
+	bool TestsMainPanel::RunningTest::endCompare( DatabaseTest const & test )
 	{
-		running = {};
+		auto it = std::find_if( comparing.begin()
+			, comparing.end()
+			, [&test]( TestNode const & lookup )
+			{
+				return lookup.test == &test;
+			} );
+
+		if ( it == comparing.end() )
+		{
+			return false;
+		}
+
+		comparing.erase( it );
+		return true;
 	}
 
 	void TestsMainPanel::RunningTest::clear()
@@ -205,12 +199,19 @@ namespace aria
 
 		pending.clear();
 
-		if ( running.test )
+		for ( auto & it : running )
 		{
-			running.test->updateStatusNW( running.status );
+			it.second.node.test->updateStatusNW( it.second.node.status );
 		}
 
-		running = {};
+		running.clear();
+
+		for ( auto & it : comparing )
+		{
+			it.test->updateStatusNW( it.status );
+		}
+
+		comparing.clear();
 	}
 
 	bool TestsMainPanel::RunningTest::empty()const
@@ -221,12 +222,41 @@ namespace aria
 	size_t TestsMainPanel::RunningTest::size()const
 	{
 		return pending.size()
-			+ ( running.test ? 1u : 0u );
+			+ running.size()
+			+ comparing.size();
 	}
 
 	bool TestsMainPanel::RunningTest::isRunning()const
 	{
-		return running.test != nullptr;
+		return !running.empty()
+			|| !comparing.empty();
+	}
+
+	bool TestsMainPanel::RunningTest::isRunning( DatabaseTest const & test )const
+	{
+		// A test still being compared is considered running, since its output files are still in use.
+		return running.end() != std::find_if( running.begin()
+				, running.end()
+				, [&test]( std::pair< long const, Running > const & lookup )
+				{
+					return lookup.second.node.test == &test;
+				} )
+			|| comparing.end() != std::find_if( comparing.begin()
+				, comparing.end()
+				, [&test]( TestNode const & lookup )
+				{
+					return lookup.test == &test;
+				} );
+	}
+
+	uint32_t TestsMainPanel::RunningTest::countRunning( Renderer renderer )const
+	{
+		return uint32_t( std::count_if( running.begin()
+			, running.end()
+			, [renderer]( std::pair< long const, Running > const & lookup )
+			{
+				return lookup.second.node.test->getRenderer() == renderer;
+			} ) );
 	}
 
 	//*********************************************************************************************
@@ -242,8 +272,21 @@ namespace aria
 		, m_fileSystem{ tests::createFileSystem( parent, eID_GIT, m_config.test ) }
 		, m_database{ *m_plugin, *m_fileSystem }
 		, m_timerKillRun{ new wxTimer{ this, eID_TIMER_KILL_RUN } }
+		, m_diffWorkers{ m_config.diffWorkers }
 		, m_testUpdater{ new wxTimer{ this, eID_TIMER_TEST_UPDATER } }
 		, m_categoriesUpdater{ new wxTimer{ this, eID_TIMER_CATEGORY_UPDATER } }
+		, m_dbJobs{ m_database
+			, [this]( DbJobQueue::Progress const & progress )
+			{
+				using wxAsyncDbJobProgressCallback = std::function< void() >;
+				using wxAsyncDbJobProgress = wxAsyncMethodCallEventFunctor< wxAsyncDbJobProgressCallback >;
+				QueueEvent( new wxAsyncDbJobProgress{ this
+					, [this, progress]()
+					{
+						onDbJobProgress( progress );
+					} } );
+			} }
+		, m_runsFlusher{ *this, m_database }
 	{
 		m_tests.runs = std::make_shared< AllTestRuns >( m_database );
 		SetMinClientSize( { 900, 600 } );
@@ -251,11 +294,18 @@ namespace aria
 
 	TestsMainPanel::~TestsMainPanel()
 	{
-		if ( m_thread.joinable() )
+		m_plugin->fileDates.setOnChange( nullptr );
+		m_loadingCancelled = true;
+
+		if ( m_loader.joinable() )
 		{
-			m_thread.join();
+			m_loader.join();
 		}
 
+		m_diffWorkers.stop();
+		m_dbJobs.stop();
+		m_runsFlusher.flush();
+
 		m_fileSystem->cleanup();
 		m_categoriesUpdater->Stop();
 		m_testUpdater->Stop();
@@ -267,12 +317,13 @@ namespace aria
 			m_runningTest.disProcess = nullptr;
 		}
 
-		if ( m_runningTest.genProcess )
+		for ( auto & running : m_runningTest.running )
 		{
-			m_runningTest.genProcess->Disconnect( wxEVT_END_PROCESS );
-			m_runningTest.genProcess = nullptr;
+			running.second.process->Disconnect( wxEVT_END_PROCESS );
 		}
 
+		m_runningTest.running.clear();
+
 		m_testsPages.clear();
 		m_auiManager.UnInit();
 	}
@@ -280,13 +331,12 @@ namespace aria
 	void TestsMainPanel::initialise()
 	{
 		{
-			wxProgressDialog progress{ _( "Initialising" )
+			DialogProgress progress{ _( "Initialising" )
 				, _( "Initialising..." )
 				, 1
 				, this };
 			int index = 0;
 			m_database.initialise( progress, index );
-			m_tests.tests = m_database.listTests( progress, index );
 			doInitGui();
 		}
 		auto onTimer = [this]( wxTimerEvent & evt )
@@ -301,31 +351,7 @@ namespace aria
 			}
 			else if ( evt.GetId() == eID_TIMER_KILL_RUN )
 			{
-				if ( wxProcess::Exists( int( m_runningTest.genProcess->GetPid() ) ) )
-				{
-					auto res = wxProcess::Kill( int( m_runningTest.genProcess->GetPid() ), wxSIGKILL );
-
-					switch ( res )
-					{
-					case wxKILL_OK:
-						break;
-					case wxKILL_BAD_SIGNAL:
-						wxLogError( "Couldn't kill process: bad signal." );
-						break;
-					case wxKILL_ACCESS_DENIED:
-						wxLogError( "Couldn't kill process: access denied." );
-						break;
-					case wxKILL_NO_PROCESS:
-						wxLogError( "Couldn't kill process: no process." );
-						break;
-					case wxKILL_ERROR:
-						wxLogError( "Couldn't kill process: error." );
-						break;
-					default:
-						wxLogError( wxString{ wxT( "Couldn't kill process: unknown error: " ) } << res );
-						break;
-					}
-				}
+				onKillRunTimer( evt );
 			}
 			else
 			{
@@ -343,23 +369,18 @@ namespace aria
 			, onTimer
 			, eID_TIMER_CATEGORY_UPDATER );
 		m_testUpdater->Start( 100 );
-		{
-			wxProgressDialog progress{ _( "Initialising" )
-				, _( "Initialising..." )
-				, 1
-				, this };
-			int index = 0;
-			doFillLists( progress, index );
-		}
 
-		m_runningTest.genProcess = std::make_unique< TestProcess >( this, wxPROCESS_DEFAULT );
 		m_runningTest.disProcess = std::make_unique< TestProcess >( this, wxPROCESS_DEFAULT );
 
 		Connect( wxEVT_END_PROCESS
 			, wxProcessEventHandler( TestsMainPanel::onProcessEnd )
 			, nullptr
 			, this );
-		m_statusText->SetLabel( _( "Idle" ) );
+		m_plugin->fileDates.setOnChange( [this]( wxFileName const & file )
+			{
+				onFileDateChanged( file );
+			} );
+		doStartLoading();
 
 		m_fileSystem->initialise();
 		auto statusBar = m_menus.statusBar;
@@ -417,32 +438,9 @@ namespace aria
 	void TestsMainPanel::pushDbJob( std::string name
 		, std::function< void() > job )
 	{
-		if ( m_thread.joinable() )
-		{
-			m_thread.join();
-		}
-
-		m_thread = std::thread{ [this, name, job]()
-			{
-				if ( auto transaction = m_database.beginTransaction( name ) )
-				{
-					try
-					{
-						job();
-						transaction.commit();
-					}
-					catch ( std::exception & exc )
-					{
-						wxLogError( "Failure: %s.", exc.what() );
-						transaction.rollback();
-					}
-					catch ( ... )
-					{
-						wxLogError( "Failure: Unknown exception." );
-						transaction.rollback();
-					}
-				}
-			} };
+		// The jobs may update the tests which runs are still queued.
+		m_runsFlusher.flush();
+		m_dbJobs.push( std::move( name ), std::move( job ) );
 	}
 
 	void TestsMainPanel::editConfig()
@@ -453,6 +451,12 @@ namespace aria
 
 	void TestsMainPanel::onRendererMenuOption( wxCommandEvent & evt )
 	{
+		// The loader thread still reads the tests map and the tests.
+		if ( !m_loaded )
+		{
+			return;
+		}
+
 		switch ( evt.GetId() )
 		{
 		case Menus::eID_RENDERER_RUN_TESTS_ALL:
@@ -493,6 +497,12 @@ namespace aria
 
 	void TestsMainPanel::onCategoryMenuOption( wxCommandEvent & evt )
 	{
+		// The loader thread still reads the tests map and the tests.
+		if ( !m_loaded )
+		{
+			return;
+		}
+
 		switch ( evt.GetId() )
 		{
 		case Menus::eID_CATEGORY_RUN_TESTS_ALL:
@@ -553,6 +563,12 @@ namespace aria
 
 	void TestsMainPanel::onTestMenuOption( wxCommandEvent & evt )
 	{
+		// The loader thread still reads the tests map and the tests.
+		if ( !m_loaded )
+		{
+			return;
+		}
+
 		switch ( evt.GetId() )
 		{
 		case Menus::eID_TEST_RUN:
@@ -605,6 +621,12 @@ namespace aria
 
 	void TestsMainPanel::onDatabaseMenuOption( wxCommandEvent & evt )
 	{
+		// The tests map is still being filled by the loader thread.
+		if ( !m_loaded )
+		{
+			return;
+		}
+
 		switch ( evt.GetId() )
 		{
 		case eID_DB_NEW_RENDERER:
@@ -657,6 +679,7 @@ namespace aria
 		{
 			auto page = new RendererPage{ *m_plugin
 				, renderer
+				, m_tests.tests
 				, rendererRuns
 				, rendererCounts
 				, m_testsBook
@@ -712,35 +735,70 @@ namespace aria
 		m_auiManager.Update();
 	}
 
-	void TestsMainPanel::doFillLists( wxProgressDialog & progress
-		, int & index )
+	void TestsMainPanel::doStartLoading()
 	{
-		uint32_t testCount = 0u;
+		wxLogMessage( "Loading tests" );
+		m_statusText->SetLabel( _( "Loading tests..." ) );
+		m_testProgress->SetRange( int( m_database.getRenderers().size() ) );
+		m_testProgress->SetValue( 0 );
+		m_testProgress->Show();
+		m_loader = std::thread{ [this]()
+			{
+				using wxAsyncLoadingCallback = std::function< void() >;
+				using wxAsyncLoading = wxAsyncMethodCallEventFunctor< wxAsyncLoadingCallback >;
 
-		for ( auto & test : m_tests.tests )
-		{
-			testCount += uint32_t( test.second.size() );
-		}
+				try
+				{
+					// The UI thread only reads the tests map from the first renderer counts on,
+					// and the menus modifying it are ignored until the loading has ended.
+					// The database reads go through a reader connection, when available,
+					// so that they don't see the uncommitted database jobs.
+					m_database.listTests( m_tests.tests );
+
+					for ( auto & renderer : m_database.getRenderers() )
+					{
+						if ( m_loadingCancelled )
+						{
+							return;
+						}
 
-		wxLogMessage( "Filling Data View" );
-		progress.SetTitle( _( "Filling Data View" ) );
-		progress.SetRange( progress.GetRange() + int( testCount * m_database.getRenderers().size() ) );
-		progress.Update( index, _( "Filling Data View..." ) );
+						auto loaded = std::make_shared< RendererTestsCounts >( *m_plugin );
 
-		for ( auto & renderer : *m_tests.runs )
-		{
-			doFillList( renderer.first, progress, index );
-		}
+						for ( auto & category : m_tests.tests )
+						{
+							loaded->addCategory( category.first, category.second );
+						}
+
+						m_database.countLatestRuns( renderer.second.get()
+							, m_tests.tests
+							, *loaded );
+						QueueEvent( new wxAsyncLoading{ this
+							, [this, rend = renderer.second.get(), loaded]()
+							{
+								onRendererLoaded( rend, *loaded );
+							} } );
+					}
+				}
+				catch ( std::exception & exc )
+				{
+					wxLogError( wxString{} << "Couldn't load the tests: " << exc.what() );
+				}
+
+				QueueEvent( new wxAsyncLoading{ this
+					, [this]()
+					{
+						onLoadingEnd();
+					} } );
+			} };
 	}
 
 	void TestsMainPanel::doFillList( Renderer renderer
-		, wxProgressDialog & progress
+		, Progress & progress
 		, int & index )
 	{
 		auto rendIt = m_testsPages.find( renderer );
 		assert( rendIt != m_testsPages.end() );
 		rendIt->second->listLatestRuns( m_database
-			, m_tests.tests
 			, *m_tests.counts
 			, progress
 			, index );
@@ -773,47 +831,82 @@ namespace aria
 		return range;
 	}
 
-	void TestsMainPanel::doProcessTest()
+	bool TestsMainPanel::doLaunchTest( TestNode testNode )
 	{
-		auto testNode = m_runningTest.next();
+		auto & test = *testNode.test;
+		auto page = doGetPage( wxDataViewItem{ testNode.node } );
 
-		if ( !m_cancelled
-			&& testNode.test )
+		if ( !page )
 		{
-			auto & test = *testNode.test;
-			test.updateStatusNW( TestStatus::eRunning_Begin );
-			auto page = doGetPage( wxDataViewItem{ testNode.node } );
+			return false;
+		}
 
-			if ( page )
-			{
-				page->updateTest( testNode.node );
-				m_statusText->SetLabel( _( "Running test: " ) + test.getName() );
-				m_timerKillRun->StartOnce( tests::timerKillTimeout );
-				auto result = m_plugin->runTest( m_runningTest.genProcess.get()
-					, test
-					, testNode.test->getRenderer()->name );
+		if ( m_database.isRunQueued( test ) )
+		{
+			// The previous run's compare image is moved when it is inserted, before being overwritten by this run.
+			m_runsFlusher.flush();
+		}
+
+		test.updateStatusNW( TestStatus::eRunning_Begin );
+		page->updateTest( testNode.node );
+		m_testProgress->SetValue( m_testProgress->GetValue() + 1 );
+		auto process = std::make_unique< TestProcess >( this, wxPROCESS_DEFAULT );
+		auto result = m_plugin->runTest( process.get()
+			, test
+			, test.getRenderer()->name );
 #if Aria_UseAsync
 
-				if ( result == 0 )
-				{
-					wxLogError( "doProcessTest failed to launch the test" );
-				}
-				else
-				{
-					m_runningTest.currentProcess = m_runningTest.genProcess.get();
-				}
+		if ( result == 0 )
+		{
+			wxLogError( "doLaunchTest failed to launch the test" );
+			test.updateStatusNW( testNode.status );
+			page->updateTest( testNode.node );
+			return false;
+		}
+
+		m_runningTest.start( result, testNode, std::move( process ) );
+
+		if ( !m_timerKillRun->IsRunning() )
+		{
+			m_timerKillRun->Start( testrun::timerKillPeriod );
+		}
 
 #else
-				onTestRunEnd( wxProcessEvent{} );
+		onTestRunEnd( testNode, int( result ) );
 #endif
-				m_testProgress->SetValue( m_testProgress->GetValue() + 1 );
+		return true;
+	}
+
+	void TestsMainPanel::doProcessTest()
+	{
+		if ( !m_cancelled )
+		{
+			auto testNode = m_runningTest.next( m_config.maxConcurrentRuns );
+
+			while ( testNode.test )
+			{
+				doLaunchTest( testNode );
+				testNode = m_runningTest.next( m_config.maxConcurrentRuns );
 			}
 		}
-		else
+
+		if ( !m_runningTest.isRunning() )
 		{
 			m_statusText->SetLabel( _( "Idle" ) );
 			m_testProgress->Hide();
 		}
+		else if ( m_runningTest.running.empty() )
+		{
+			m_statusText->SetLabel( _( "Comparing results" ) );
+		}
+		else if ( m_runningTest.running.size() == 1u )
+		{
+			m_statusText->SetLabel( _( "Running test: " ) + m_runningTest.running.begin()->second.node.test->getName() );
+		}
+		else
+		{
+			m_statusText->SetLabel( wxString{} << _( "Running tests: " ) << m_runningTest.running.size() );
+		}
 
 		auto statusBar = m_menus.statusBar;
 		auto sizer = statusBar->GetSizer();
@@ -830,9 +923,10 @@ namespace aria
 		{
 			m_testProgress->SetValue( 0 );
 			m_testProgress->Show();
-			doProcessTest();
 		}
 
+		doProcessTest();
+
 		if ( m_selectedPage )
 		{
 			m_selectedPage->refreshView();
@@ -974,6 +1068,18 @@ namespace aria
 			if ( auto category = tests::selectCategory( this, m_database ) )
 			{
 				auto items = m_selectedPage->listSelectedTests();
+
+				// The moved tests must be loaded in every page, before the job changes their category.
+				for ( auto & page : m_testsPages )
+				{
+					page.second->loadCategory( category );
+
+					for ( auto & item : items )
+					{
+						page.second->loadCategory( static_cast< TestTreeModelNode * >( item.GetID() )->category );
+					}
+				}
+
 				pushDbJob( "changeTestCategory"
 					, [this, category, items]()
 					{
@@ -1017,7 +1123,7 @@ namespace aria
 						{
 							auto evtHandler = page.second;
 							QueueEvent( new wxAsyncUpdateTestCategory{ evtHandler
-								, [evtHandler, &toMove, &category]()
+								, [evtHandler, toMove, category]()
 								{
 									evtHandler->changeTestsCategory( toMove, category );
 								} } );
@@ -1108,6 +1214,8 @@ namespace aria
 	{
 		auto & test = *dbTest->test;
 		auto name = test.name;
+		// The queued runs refer to the removed tests.
+		m_runsFlusher.flush();
 
 		for ( auto & page : m_testsPages )
 		{
@@ -1290,6 +1398,8 @@ namespace aria
 		, bool commit )
 	{
 		auto name = category->name;
+		// The queued runs refer to the removed tests.
+		m_runsFlusher.flush();
 
 		for ( auto & page : m_testsPages )
 		{
@@ -1717,6 +1827,11 @@ namespace aria
 
 	std::vector< wxDataViewItem > TestsMainPanel::doListAllTests( FilterFunc filter )
 	{
+		for ( auto & page : m_testsPages )
+		{
+			page.second->loadAllCategories();
+		}
+
 		DatabaseTestArray runs;
 		m_tests.runs->listTests( filter, runs );
 		std::vector< wxDataViewItem > result;
@@ -1766,7 +1881,7 @@ namespace aria
 			auto renderer = m_database.createRenderer( makeStdString( dialog.GetValue() ) );
 			m_tests.runs->addRenderer( renderer );
 			auto range = doGetAllTestsRange();
-			wxProgressDialog progress{ _( "Creating renderer entries" )
+			DialogProgress progress{ _( "Creating renderer entries" )
 				, _( "Creating renderer entries..." )
 				, int( range )
 				, this };
@@ -1842,6 +1957,9 @@ namespace aria
 				for ( auto & rendererIt : m_database.getRenderers() )
 				{
 					auto renderer = rendererIt.second.get();
+					auto rendPageIt = m_testsPages.find( renderer );
+					// Loaded before the test is added, else it would be listed twice.
+					rendPageIt->second->loadCategory( category );
 					auto & rendRuns = m_tests.runs->getRenderer( renderer );
 					auto & rendCounts = m_tests.counts->getRenderer( renderer );
 					auto & catCounts = rendCounts.getCounts( category );
@@ -1853,7 +1971,6 @@ namespace aria
 						, db::DateTime{}
 					, TestTimes{} } );
 
-					auto rendPageIt = m_testsPages.find( renderer );
 					rendPageIt->second->addTest( dbTest );
 					catCounts.addTest( dbTest );
 				}
@@ -1869,6 +1986,11 @@ namespace aria
 		std::stringstream stream;
 		stream.imbue( std::locale{ "C" } );
 
+		for ( auto & page : m_testsPages )
+		{
+			page.second->loadAllCategories();
+		}
+
 		for ( auto & runs : *m_tests.runs )
 		{
 			for ( auto & run : runs.second )
@@ -1896,11 +2018,10 @@ namespace aria
 		}
 	}
 
-	void TestsMainPanel::onTestRunEnd( int status )
+	void TestsMainPanel::onTestRunEnd( TestNode testNode
+		, int status )
 	{
-		auto testNode = m_runningTest.current();
 		auto & run = *testNode.test;
-		m_timerKillRun->Stop();
 
 		if ( status < 0 && status != std::numeric_limits< int >::max() )
 		{
@@ -1909,48 +2030,58 @@ namespace aria
 
 		if ( !m_cancelled )
 		{
-			DiffOptions options;
-			auto file = ( m_config.test / run.getCategory()->name / m_plugin->getTestName( *run ) );
-			options.input = file.GetPath() / ( file.GetName() + wxT( "_ref.png" ) );
-			options.outputs.emplace_back( file.GetPath() / wxT( "Compare" ) / ( file.GetName() + wxT( "_" ) + run.getRenderer()->name + wxT( ".png" ) ) );
-			auto times = tests::processTestOutputTimes( m_database
-				, file.GetPath() / wxT( "Compare" ) / ( file.GetName() + wxT( "_" ) + run.getRenderer()->name + wxT( ".times" ) ) );
-
-			try
-			{
-				DiffConfig config{ options };
-
-				for ( auto output : options.outputs )
+			auto times = m_database.processTestOutputTimes( testrun::getTimesFile( *m_plugin, run ) );
+			m_runningTest.compare( testNode );
+			m_diffWorkers.push( testrun::getDiffOptions( *m_plugin, run )
+				, [this, testNode, times]( DiffWorkerPool::Result const & result )
 				{
-					compareImages( options, config, output );
-				}
+					using wxAsyncCompareEndCallback = std::function< void() >;
+					using wxAsyncCompareEnd = wxAsyncMethodCallEventFunctor< wxAsyncCompareEndCallback >;
+					QueueEvent( new wxAsyncCompareEnd{ this
+						, [this, testNode, times, result]()
+						{
+							onTestCompareEnd( testNode, times, result );
+						} } );
+				} );
+			// The comparison happens in background, the freed launcher slot can be used right away.
+			doProcessTest();
+		}
+		else
+		{
+			doCancelTest( run, testNode.node->statusName.status );
+		}
+	}
 
-				onTestDiffEnd( times );
-			}
-			catch ( std::exception & exc )
-			{
-				wxLogWarning( wxString() << "Test result comparison not possible: " << exc.what() );
-				TestNode curTestNode = m_runningTest.current();
-				auto & test = *curTestNode.test;
-				test.createNewRun( TestStatus::eUnprocessed
-					, wxDateTime::Now()
-					, times );
+	void TestsMainPanel::onTestCompareEnd( TestNode testNode
+		, TestTimes const & times
+		, DiffWorkerPool::Result const & result )
+	{
+		if ( !m_runningTest.endCompare( *testNode.test ) )
+		{
+			// The runs have been cleared (cancelled) in the meantime.
+			return;
+		}
 
-				auto page = doGetPage( wxDataViewItem{ curTestNode.node } );
+		if ( m_cancelled )
+		{
+			doCancelTest( *testNode.test, testNode.node->statusName.status );
+			return;
+		}
 
-				if ( page )
-				{
-					page->updateTest( curTestNode.node );
-					page->updateTestView( test, *m_tests.counts );
-				}
+		wxLogMessage( wxString() << "Test run ended" );
+		auto & test = *testNode.test;
+		testrun::queueNewRun( test, times, result );
+		m_runsFlusher.queue();
 
-				doProcessTest();
-			}
-		}
-		else
+		auto page = doGetPage( wxDataViewItem{ testNode.node } );
+
+		if ( page )
 		{
-			doCancelTest( run, testNode.node->statusName.status );
+			page->updateTest( testNode.node );
+			page->updateTestView( test, *m_tests.counts );
 		}
+
+		doProcessTest();
 	}
 
 	void TestsMainPanel::onTestDisplayEnd( int status )
@@ -1958,71 +2089,125 @@ namespace aria
 		wxLogMessage( wxString() << "Test display ended (" << status << ")" );
 	}
 
-	void TestsMainPanel::onTestDiffEnd( TestTimes const & times )
+	bool TestsMainPanel::onTestProcessEnd( int pid, int status )
 	{
-		wxLogMessage( wxString() << "Test run ended" );
-		TestNode testNode = m_runningTest.current();
-		auto & test = *testNode.test;
-
-		if ( !m_cancelled )
+		if ( m_runningTest.disProcess
+			&& m_runningTest.disProcess->GetPid() == pid )
 		{
-			auto resultName = getResultName( *test ).GetFullName();
-			auto matches = filterDirectoryFiles( m_config.test / getCompareFolder( *test->test )
-				, [&resultName]( wxString const & folder, wxString name )
-				{
-					return name.find( resultName ) == 0u;
-				}
-			, true );
-			assert( matches.size() < 2 );
+			onTestDisplayEnd( status );
+			return true;
+		}
 
-			if ( !matches.empty() )
-			{
-				test.createNewRun( matches[0], times );
-			}
-			else
-			{
-				test.createNewRun( TestStatus::eCrashed
-					, wxDateTime::Now()
-					, times );
-			}
+		if ( m_runningTest.find( pid ) )
+		{
+			onTestRunEnd( m_runningTest.end( pid ), status );
+			return true;
+		}
 
-			auto page = doGetPage( wxDataViewItem{ testNode.node } );
+		return false;
+	}
 
-			if ( page )
-			{
-				page->updateTest( testNode.node );
-				page->updateTestView( test, *m_tests.counts );
-			}
+	void TestsMainPanel::onRendererLoaded( Renderer renderer
+		, RendererTestsCounts & loaded )
+	{
+		auto rendIt = m_testsPages.find( renderer );
 
-			doProcessTest();
-		}
-		else
+		if ( rendIt != m_testsPages.end() )
 		{
-			doCancelTest( *testNode.test, testNode.node->statusName.status );
+			rendIt->second->addLatestCounts( m_database
+				, *m_tests.counts
+				, loaded );
 		}
+
+		m_testProgress->SetValue( m_testProgress->GetValue() + 1 );
 	}
 
-	bool TestsMainPanel::onTestProcessEnd( int pid, int status )
+	void TestsMainPanel::onLoadingEnd()
+	{
+		m_loader.join();
+		m_loaded = true;
+		m_testProgress->Hide();
+		m_statusText->SetLabel( _( "Idle" ) );
+		auto statusBar = m_menus.statusBar;
+		auto sizer = statusBar->GetSizer();
+		assert( sizer != nullptr );
+		sizer->SetSizeHints( statusBar );
+		sizer->Layout();
+	}
+
+	void TestsMainPanel::onFileDateChanged( wxFileName const & file )
 	{
-		auto currentProcess = m_runningTest.currentProcess;
-		m_runningTest.currentProcess = nullptr;
+		// A scene file only impacts its tests, the other watched files (the engine) impact all of them.
+		bool isScene = m_plugin->isSceneFile( file.GetFullPath() );
 
-		if ( currentProcess )
+		if ( !isScene )
 		{
-			if ( currentProcess == m_runningTest.disProcess.get() )
+			// The runs statuses aggregates count the outdated runs against the engine reference date.
+			m_plugin->updateEngineRefDate();
+		}
+
+		for ( auto & rendererRuns : *m_tests.runs )
+		{
+			auto pageIt = m_testsPages.find( rendererRuns.first );
+
+			for ( auto & run : rendererRuns.second )
 			{
-				onTestDisplayEnd( status );
-				return true;
+				if ( isScene
+					&& m_plugin->getTestFileName( run ) != file )
+				{
+					continue;
+				}
+
+				run.updateOutOfDate();
+
+				if ( isScene
+					&& pageIt != m_testsPages.end()
+					&& pageIt->second->getTestNode( run ) )
+				{
+					pageIt->second->updateTestView( run, *m_tests.counts );
+				}
 			}
 
-			if ( currentProcess == m_runningTest.genProcess.get() )
+			if ( !isScene
+				&& pageIt != m_testsPages.end() )
 			{
-				onTestRunEnd( status );
-				return true;
+				try
+				{
+					pageIt->second->updateUnloadedOutdated( m_database );
+				}
+				catch ( std::exception & exc )
+				{
+					wxLogError( wxString() << "Couldn't count the outdated tests: " << exc.what() );
+				}
+
+				pageIt->second->refreshView();
 			}
 		}
+	}
 
-		return false;
+	void TestsMainPanel::onDbJobProgress( DbJobQueue::Progress const & progress )
+	{
+		// Running tests, and the tests loading, own the status bar.
+		if ( !m_statusText || !m_loaded || m_runningTest.isRunning() )
+		{
+			return;
+		}
+
+		if ( progress.done < progress.total )
+		{
+			m_statusText->SetLabel( wxString{} << _( "Updating database: " ) << progress.name
+				<< " (" << progress.done << "/" << progress.total << ")" );
+		}
+		else
+		{
+			m_statusText->SetLabel( _( "Idle" ) );
+		}
+
+		auto statusBar = m_menus.statusBar;
+		auto sizer = statusBar->GetSizer();
+		assert( sizer != nullptr );
+		sizer->SetSizeHints( statusBar );
+		sizer->Layout();
 	}
 
 	void TestsMainPanel::onTestsPageChange( wxAuiNotebookEvent & evt )
@@ -2043,14 +2228,12 @@ namespace aria
 
 	void TestsMainPanel::onTestUpdateTimer( wxTimerEvent & evt )
 	{
-		auto testNode = m_runningTest.current();
-
-		if ( !testNode.test )
+		auto nextStatus = []( TestStatus status )
 		{
-			return;
-		}
-
-		TestTreeModelNode * node{ testNode.node };
+			return ( status == TestStatus::eRunning_End )
+				? TestStatus::eRunning_Begin
+				: TestStatus( uint32_t( status ) + 1 );
+		};
 		auto updatePage = [this]( TestTreeModelNode * treeNode )
 		{
 			auto page = doGetPage( wxDataViewItem{ treeNode } );
@@ -2062,34 +2245,74 @@ namespace aria
 
 			return treeNode->GetParent();
 		};
+		// Categories and renderers holding several running tests must be animated only once.
+		std::set< TestTreeModelNode * > parents;
+		auto updateTest = [&nextStatus, &updatePage, &parents]( TestTreeModelNode * node )
+		{
+			if ( node && isTestNode( *node ) )
+			{
+				node->test->updateStatusNW( nextStatus( node->test->getStatus() ) );
+				node = updatePage( node );
+			}
+
+			if ( node )
+			{
+				parents.insert( node );
+			}
+		};
 
-		if ( node && isTestNode( *node ) )
+		for ( auto & running : m_runningTest.running )
 		{
-			node->test->updateStatusNW( ( node->test->getStatus() == TestStatus::eRunning_End )
-				? TestStatus::eRunning_Begin
-				: TestStatus( uint32_t( node->test->getStatus() ) + 1 ) );
-			node = updatePage( node );
+			updateTest( running.second.node.node );
 		}
 
-		if ( node && isCategoryNode( *node ) )
+		for ( auto & comparing : m_runningTest.comparing )
 		{
-			node->statusName.status = ( node->statusName.status == TestStatus::eRunning_End )
-				? TestStatus::eRunning_Begin
-				: TestStatus( uint32_t( node->statusName.status ) + 1 );
-			node = updatePage( node );
+			updateTest( comparing.node );
 		}
 
-		if ( node && isRendererNode( *node ) )
+		while ( !parents.empty() )
 		{
-			node->statusName.status = ( node->statusName.status == TestStatus::eRunning_End )
-				? TestStatus::eRunning_Begin
-				: TestStatus( uint32_t( node->statusName.status ) + 1 );
-			updatePage( node );
+			std::set< TestTreeModelNode * > nextParents;
+
+			for ( auto node : parents )
+			{
+				if ( isCategoryNode( *node ) || isRendererNode( *node ) )
+				{
+					node->statusName.status = nextStatus( node->statusName.status );
+
+					if ( auto parent = updatePage( node ) )
+					{
+						nextParents.insert( parent );
+					}
+				}
+			}
+
+			parents = std::move( nextParents );
 		}
 
 		evt.Skip();
 	}
 
+	void TestsMainPanel::onKillRunTimer( wxTimerEvent & evt )
+	{
+		if ( !m_runningTest.isRunning() )
+		{
+			m_timerKillRun->Stop();
+			return;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+
+		for ( auto & running : m_runningTest.running )
+		{
+			testrun::killIfTimedOut( running.first
+				, running.second.start
+				, now
+				, running.second.node.test->getName() );
+		}
+	}
+
 	void TestsMainPanel::onCategoryUpdateTimer( wxTimerEvent & evt )
 	{
 		evt.Skip();
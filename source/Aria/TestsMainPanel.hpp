@@ -4,7 +4,10 @@ See LICENSE file in root folder
 #ifndef ___CTP_TestsMainPanel_HPP___
 #define ___CTP_TestsMainPanel_HPP___
 
+#include "DbJobQueue.hpp"
+#include "DiffWorkerPool.hpp"
 #include "RendererPage.hpp"
+#include "TestRunHelpers.hpp"
 
 #include <AriaLib/Plugin.hpp>
 #include <AriaLib/Database/DbConnection.hpp>
@@ -20,7 +23,9 @@ See LICENSE file in root folder
 #include <wx/aui/framemanager.h>
 #include <wx/aui/auibook.h>
 
+#include <chrono>
 #include <map>
+#include <thread>
 #include <AriaLib/EndExternHeaderGuard.hpp>
 
 namespace aria
@@ -58,22 +63,37 @@ namespace aria
 
 		struct RunningTest
 		{
-			std::unique_ptr< wxProcess > genProcess{};
+			struct Running
+			{
+				std::unique_ptr< wxProcess > process{};
+				TestNode node{};
+				std::chrono::steady_clock::time_point start{};
+			};
+
 			std::unique_ptr< wxProcess > disProcess{};
-			wxProcess * currentProcess{};
+			std::map< long, Running > running{};
+			std::list< TestNode > comparing{};
 
-			TestNode current();
 			void push( TestNode node );
-			TestNode next();
-			void end();
+			TestNode next( uint32_t maxPerRenderer );
+			void start( long pid
+				, TestNode node
+				, std::unique_ptr< wxProcess > process );
+			Running * find( long pid );
+			TestNode end( long pid );
+			void compare( TestNode node );
+			bool endCompare( DatabaseTest const & test );
 			void clear();
 			bool empty()const;
 			size_t size()const;
 			bool isRunning()const;
 
+		private:
+			bool isRunning( DatabaseTest const & test )const;
+			uint32_t countRunning( Renderer renderer )const;
+
 		private:
 			std::list< TestNode > pending{};
-			TestNode running{};
 		};
 
 	public:
@@ -111,13 +131,14 @@ namespace aria
 		wxWindow * doInitTestsLists();
 		void doInitTestsList( Renderer renderer );
 		void doInitGui();
-		void doFillLists( wxProgressDialog & progress, int & index );
+		void doStartLoading();
 		void doFillList( Renderer renderer
-			, wxProgressDialog & progress
+			, Progress & progress
 			, int & index );
 		RendererPage * doGetPage( wxDataViewItem const & item );
 
 		uint32_t doGetAllTestsRange()const;
+		bool doLaunchTest( TestNode testNode );
 		void doProcessTest();
 		void doStartTests();
 		void doPushTest( wxDataViewItem & item
@@ -176,14 +197,23 @@ namespace aria
 			, std::string const & commitText
 			, bool commit );
 		void doDeleteCategory();
-		void onTestRunEnd( int status );
+		void onTestRunEnd( TestNode testNode
+			, int status );
+		void onTestCompareEnd( TestNode testNode
+			, TestTimes const & times
+			, DiffWorkerPool::Result const & result );
 		void onTestDisplayEnd( int status );
-		void onTestDiffEnd( TestTimes const & times );
 		bool onTestProcessEnd( int pid, int status );
+		void onRendererLoaded( Renderer renderer
+			, RendererTestsCounts & loaded );
+		void onLoadingEnd();
+		void onFileDateChanged( wxFileName const & file );
+		void onDbJobProgress( DbJobQueue::Progress const & progress );
 
 		void onTestsPageChange( wxAuiNotebookEvent & evt );
 		void onProcessEnd( wxProcessEvent & evt );
 		void onTestUpdateTimer( wxTimerEvent & evt );
+		void onKillRunTimer( wxTimerEvent & evt );
 		void onCategoryUpdateTimer( wxTimerEvent & evt );
 		void onSize( wxSizeEvent & evt );
 
@@ -203,9 +233,14 @@ namespace aria
 		RunningTest m_runningTest;
 		wxTimer * m_timerKillRun{};
 		std::atomic_bool m_cancelled;
+		DiffWorkerPool m_diffWorkers;
 		wxTimer * m_testUpdater;
 		wxTimer * m_categoriesUpdater;
-		std::thread m_thread;
+		DbJobQueue m_dbJobs;
+		std::thread m_loader;
+		std::atomic_bool m_loadingCancelled{};
+		bool m_loaded{};
+		RunsFlusher m_runsFlusher;
 	};
 }
 
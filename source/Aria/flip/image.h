@@ -51,6 +51,7 @@
 #pragma once
 
 #include "sharedflip.h"
+#include "simd.h"
 #include "tensor.h"
 
 namespace FLIP
@@ -210,13 +211,17 @@ namespace FLIP
 
         void FLIP(image<color3>& reference, image<color3>& test, float ppd)
         {
-            int width = reference.getWidth();
-            int height = reference.getHeight();
-
             // Transform from sRGB to YCxCz.
             reference.sRGB2YCxCz();
             test.sRGB2YCxCz();
 
+            this->FLIPYCxCz(reference, test, ppd);
+        }
+
+        // Same as FLIP(), for reference and test images that are already in YCxCz space.
+        // Both images are left untouched, so they can be shared between several comparisons.
+        void FLIPYCxCz(const image<color3>& reference, const image<color3>& test, float ppd)
+        {
             // Prepare separated spatial filters. Because the filter for the Blue-Yellow channel is a sum of two Gaussians, we need to separate the spatial filter into two
             // (YCx for the Achromatic and Red-Green channels and Cz for the Blue-Yellow channel).
             int spatialFilterRadius = calculateSpatialFilterRadius(ppd);
@@ -241,6 +246,252 @@ namespace FLIP
             this->computeFeatureDifferenceAndFinalError(reference, test, featureFilter);
         }
 
+        // Same as FLIPYCxCz(), for YCxCz images stored as structure-of-arrays planes.
+        // The convolutions and the linear parts of the colour conversions use the vectorised kernels from simd.h.
+        void FLIPYCxCz(const simd::planes3& reference, const simd::planes3& test, float ppd)
+        {
+            int spatialFilterRadius = calculateSpatialFilterRadius(ppd);
+            int spatialFilterWidth = 2 * spatialFilterRadius + 1;
+            image<color3> spatialFilterYCx(spatialFilterWidth, 1);
+            image<color3> spatialFilterCz(spatialFilterWidth, 1);
+            setSpatialFilters(spatialFilterYCx, spatialFilterCz, ppd, spatialFilterRadius);
+            this->computeColorDifference(reference, test
+                , getFilterWeights(spatialFilterYCx, 0).data(), getFilterWeights(spatialFilterYCx, 1).data()
+                , getFilterWeights(spatialFilterCz, 0).data(), getFilterWeights(spatialFilterCz, 1).data()
+                , spatialFilterRadius);
+
+            const float stdDev = 0.5f * FLIPConstants.gw * ppd;
+            const int featureFilterRadius = int(std::ceil(3.0f * stdDev));
+            int featureFilterWidth = 2 * featureFilterRadius + 1;
+            image<color3> featureFilter(featureFilterWidth, 1);
+            setFeatureFilter(featureFilter, ppd);
+            this->computeFeatureDifferenceAndFinalError(reference, test
+                , getFilterWeights(featureFilter, 0).data(), getFilterWeights(featureFilter, 1).data(), getFilterWeights(featureFilter, 2).data()
+                , featureFilterRadius);
+        }
+
+        // Extracts one channel of a 1D filter, as a contiguous array of weights.
+        static std::vector<float> getFilterWeights(const image<color3>& filter, int channel)
+        {
+            std::vector<float> result(size_t(filter.getWidth()));
+
+            for (int x = 0; x < filter.getWidth(); x++)
+            {
+                const color3 weights = filter.get(x, 0);
+                result[x] = (channel == 0 ? weights.x : (channel == 1 ? weights.y : weights.z));
+            }
+
+            return result;
+        }
+
+        // Same as computeColorDifference(), on structure-of-arrays planes, with one weights array per filter channel.
+        void computeColorDifference(const simd::planes3& referenceImage, const simd::planes3& testImage, const float* filterY, const float* filterCx, const float* filterCz1, const float* filterCz2, const int halfFilterWidth)
+        {
+            const float cmax = color3::computeMaxDistance(FLIPConstants.gqc);
+            const float pccmax = FLIPConstants.gpc * cmax;
+            const float* filters[4] = { filterY, filterCx, filterCz1, filterCz2 };
+            const simd::planes3* images[2] = { &referenceImage, &testImage };
+
+            const int w = referenceImage.getWidth();
+            const int h = referenceImage.getHeight();
+
+            // Intermediate planes, for both images: Y, Cx, and Cz filtered by each of its two Gaussians.
+            std::vector<float> intermediate[2][4];
+
+            for (auto& planes : intermediate)
+            {
+                for (auto& plane : planes)
+                {
+                    plane.resize(size_t(w) * size_t(h));
+                }
+            }
+
+            // Filter in x direction.
+#pragma omp parallel for
+            for (int y = 0; y < h; y++)
+            {
+                for (int i = 0; i < 2; i++)
+                {
+                    const size_t offset = size_t(y) * size_t(w);
+                    simd::convolveRow(images[i]->getRow(0, y), intermediate[i][0].data() + offset, w, filters[0], halfFilterWidth);
+                    simd::convolveRow(images[i]->getRow(1, y), intermediate[i][1].data() + offset, w, filters[1], halfFilterWidth);
+                    simd::convolveRow(images[i]->getRow(2, y), intermediate[i][2].data() + offset, w, filters[2], halfFilterWidth);
+                    simd::convolveRow(images[i]->getRow(2, y), intermediate[i][3].data() + offset, w, filters[3], halfFilterWidth);
+                }
+            }
+
+            // Filter in y direction, then compute the difference.
+#pragma omp parallel
+            {
+                std::vector<float> rows[2][4];
+
+                for (auto& planes : rows)
+                {
+                    for (auto& row : planes)
+                    {
+                        row.resize(size_t(w));
+                    }
+                }
+
+#pragma omp for
+                for (int y = 0; y < h; y++)
+                {
+                    for (int i = 0; i < 2; i++)
+                    {
+                        for (int c = 0; c < 4; c++)
+                        {
+                            simd::convolveColumn(intermediate[i][c].data(), rows[i][c].data(), w, h, y, filters[c], halfFilterWidth);
+                        }
+
+                        for (int x = 0; x < w; x++)
+                        {
+                            rows[i][2][x] += rows[i][3][x];
+                        }
+
+                        // Clamp to [0,1] in linear RGB, and move back to XYZ.
+                        simd::YCxCz2ClampedXYZ(rows[i][0].data(), rows[i][1].data(), rows[i][2].data(), w);
+                    }
+
+                    for (int x = 0; x < w; x++)
+                    {
+                        // Move to CIELab.
+                        color3 filteredReference = normalizedXYZ2CIELab(color3(rows[0][0][x], rows[0][1][x], rows[0][2][x]));
+                        color3 filteredTest = normalizedXYZ2CIELab(color3(rows[1][0][x], rows[1][1][x], rows[1][2][x]));
+
+                        // Apply Hunt adjustment.
+                        filteredReference.y = color3::Hunt(filteredReference.x, filteredReference.y);
+                        filteredReference.z = color3::Hunt(filteredReference.x, filteredReference.z);
+                        filteredTest.y = color3::Hunt(filteredTest.x, filteredTest.y);
+                        filteredTest.z = color3::Hunt(filteredTest.x, filteredTest.z);
+
+                        float colorDifference = color3::HyAB(filteredReference, filteredTest);
+
+                        colorDifference = powf(colorDifference, FLIPConstants.gqc);
+
+                        if (colorDifference < pccmax)
+                        {
+                            colorDifference *= FLIPConstants.gpt / pccmax;
+                        }
+                        else
+                        {
+                            colorDifference = FLIPConstants.gpt + ((colorDifference - pccmax) / (cmax - pccmax)) * (1.0f - FLIPConstants.gpt);
+                        }
+
+                        this->set(x, y, colorDifference);
+                    }
+                }
+            }
+        }
+
+        // Same as color3::XYZ2CIELab(), for XYZ values already divided by the reference illuminant.
+        static inline color3 normalizedXYZ2CIELab(color3 XYZ)
+        {
+            const float delta = 6.0f / 29.0f;
+            const float deltaSquare = delta * delta;
+            const float deltaCube = delta * deltaSquare;
+            const float factor = 1.0f / (3.0f * deltaSquare);
+            const float term = 4.0f / 29.0f;
+
+            XYZ.x = (XYZ.x > deltaCube ? powf(XYZ.x, 1.0f / 3.0f) : factor * XYZ.x + term);
+            XYZ.y = (XYZ.y > deltaCube ? powf(XYZ.y, 1.0f / 3.0f) : factor * XYZ.y + term);
+            XYZ.z = (XYZ.z > deltaCube ? powf(XYZ.z, 1.0f / 3.0f) : factor * XYZ.z + term);
+
+            return color3(116.0f * XYZ.y - 16.0f, 500.0f * (XYZ.x - XYZ.y), 200.0f * (XYZ.y - XYZ.z));
+        }
+
+        // Same as computeFeatureDifferenceAndFinalError(), on structure-of-arrays planes, with one weights array per filter channel.
+        void computeFeatureDifferenceAndFinalError(const simd::planes3& referenceImage, const simd::planes3& testImage, const float* filterG, const float* filterDG, const float* filterDDG, const int halfFilterWidth)
+        {
+            const float normalizationFactor = 1.0f / std::sqrt(2.0f);
+            const simd::planes3* images[2] = { &referenceImage, &testImage };
+            const int w = referenceImage.getWidth();
+            const int h = referenceImage.getHeight();
+
+            // Intermediate planes, for both images: 1st and 2nd x-derivatives, and Gaussian.
+            std::vector<float> intermediate[2][3];
+
+            for (auto& planes : intermediate)
+            {
+                for (auto& plane : planes)
+                {
+                    plane.resize(size_t(w) * size_t(h));
+                }
+            }
+
+            // Convolve in x direction.
+            const float oneOver116 = 1.0f / 116.0f;
+            const float sixteenOver116 = 16.0f / 116.0f;
+#pragma omp parallel
+            {
+                std::vector<float> normalized(static_cast<size_t>(w));
+
+#pragma omp for
+                for (int y = 0; y < h; y++)
+                {
+                    for (int i = 0; i < 2; i++)
+                    {
+                        // Normalize the Y values to [0,1].
+                        const float* row = images[i]->getRow(0, y);
+
+                        for (int x = 0; x < w; x++)
+                        {
+                            normalized[x] = row[x] * oneOver116 + sixteenOver116;
+                        }
+
+                        const size_t offset = size_t(y) * size_t(w);
+                        simd::convolveRow(normalized.data(), intermediate[i][0].data() + offset, w, filterDG, halfFilterWidth);
+                        simd::convolveRow(normalized.data(), intermediate[i][1].data() + offset, w, filterDDG, halfFilterWidth);
+                        simd::convolveRow(normalized.data(), intermediate[i][2].data() + offset, w, filterG, halfFilterWidth);
+                    }
+                }
+            }
+
+            // Convolve in y direction, then compute the final error.
+#pragma omp parallel
+            {
+                // For both images: dx, ddx, dy, ddy.
+                std::vector<float> rows[2][4];
+
+                for (auto& planes : rows)
+                {
+                    for (auto& row : planes)
+                    {
+                        row.resize(size_t(w));
+                    }
+                }
+
+#pragma omp for
+                for (int y = 0; y < h; y++)
+                {
+                    for (int i = 0; i < 2; i++)
+                    {
+                        simd::convolveColumn(intermediate[i][0].data(), rows[i][0].data(), w, h, y, filterG, halfFilterWidth);
+                        simd::convolveColumn(intermediate[i][1].data(), rows[i][1].data(), w, h, y, filterG, halfFilterWidth);
+                        simd::convolveColumn(intermediate[i][2].data(), rows[i][2].data(), w, h, y, filterDG, halfFilterWidth);
+                        simd::convolveColumn(intermediate[i][2].data(), rows[i][3].data(), w, h, y, filterDDG, halfFilterWidth);
+                    }
+
+                    for (int x = 0; x < w; x++)
+                    {
+                        const float edgeValueRef = std::sqrt(rows[0][0][x] * rows[0][0][x] + rows[0][2][x] * rows[0][2][x]);
+                        const float edgeValueTest = std::sqrt(rows[1][0][x] * rows[1][0][x] + rows[1][2][x] * rows[1][2][x]);
+                        const float pointValueRef = std::sqrt(rows[0][1][x] * rows[0][1][x] + rows[0][3][x] * rows[0][3][x]);
+                        const float pointValueTest = std::sqrt(rows[1][1][x] * rows[1][1][x] + rows[1][3][x] * rows[1][3][x]);
+
+                        const float edgeDifference = std::abs(edgeValueRef - edgeValueTest);
+                        const float pointDifference = std::abs(pointValueRef - pointValueTest);
+
+                        const float featureDifference = std::pow(normalizationFactor * Max(edgeDifference, pointDifference), FLIPConstants.gqf);
+                        const float colorDifference = this->get(x, y);
+
+                        const float errorFLIP = std::pow(colorDifference, 1.0f - featureDifference);
+
+                        this->set(x, y, errorFLIP);
+                    }
+                }
+            }
+        }
+
         // Performs spatial filtering (and clamps the results) on both the reference and test image at the same time (for better performance).
         // Filtering has been changed to separable filtering for better performance. For details on the convolution, see separatedConvolutions.pdf in the FLIP repository.
         // After filtering, compute color differences. referenceImage and testImage are expected to be in YCxCz space.
@@ -0,0 +1,642 @@
+// Vectorised kernels for the FLIP evaluator.
+// The images are stored as structure-of-arrays planes (one contiguous plane per channel),
+// so that the separable convolutions and the linear parts of the colour space conversions
+// can process 4 (SSE4.1) or 8 (AVX2) pixels at once.
+// The instruction set is selected at runtime, with a scalar fallback.
+// Each kernel performs the same operations in the same order as the scalar code, so all paths give
+// the same results, unless the compiler contracts some multiply-adds into FMAs in one of them,
+// which changes the rounding of the last bits. checkKernels() verifies they match within a tolerance.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sharedflip.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#   define FLIP_SIMD_X86 1
+#   include <immintrin.h>
+#   if defined(_MSC_VER) && !defined(__clang__)
+#       include <intrin.h>
+#       define FLIP_TARGET_SSE41
+#       define FLIP_TARGET_AVX2
+#   else
+#       define FLIP_TARGET_SSE41 __attribute__((target("sse4.1")))
+#       define FLIP_TARGET_AVX2 __attribute__((target("avx2")))
+#   endif
+#else
+#   define FLIP_SIMD_X86 0
+#endif
+
+namespace FLIP
+{
+    namespace simd
+    {
+        enum class Level
+        {
+            Scalar,
+            SSE41,
+            AVX2,
+        };
+
+        static inline Level detectLevel(void)
+        {
+#if FLIP_SIMD_X86
+#   if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            const int maxLeaf = info[0];
+            __cpuid(info, 1);
+            const bool sse41 = (info[2] & (1 << 19)) != 0;
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            bool avx2 = false;
+
+            if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+            {
+                __cpuidex(info, 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+#   else
+            __builtin_cpu_init();
+            const bool sse41 = __builtin_cpu_supports("sse4.1");
+            const bool avx2 = __builtin_cpu_supports("avx2");
+#   endif
+
+            if (avx2)
+            {
+                return Level::AVX2;
+            }
+
+            if (sse41)
+            {
+                return Level::SSE41;
+            }
+#endif
+            return Level::Scalar;
+        }
+
+        static inline Level getLevel(void)
+        {
+            static const Level level = detectLevel();
+            return level;
+        }
+
+        // Three channel image, stored as three contiguous planes.
+        class planes3
+        {
+        public:
+            planes3(const int width, const int height)
+                : mWidth(width)
+                , mHeight(height)
+            {
+                for (auto& plane : mPlanes)
+                {
+                    plane.resize(size_t(width) * size_t(height));
+                }
+            }
+
+            int getWidth(void) const
+            {
+                return mWidth;
+            }
+
+            int getHeight(void) const
+            {
+                return mHeight;
+            }
+
+            float* getPlane(int channel)
+            {
+                return mPlanes[channel].data();
+            }
+
+            const float* getPlane(int channel) const
+            {
+                return mPlanes[channel].data();
+            }
+
+            float* getRow(int channel, int y)
+            {
+                return getPlane(channel) + size_t(y) * size_t(mWidth);
+            }
+
+            const float* getRow(int channel, int y) const
+            {
+                return getPlane(channel) + size_t(y) * size_t(mWidth);
+            }
+
+        private:
+            int mWidth;
+            int mHeight;
+            std::vector<float> mPlanes[3];
+        };
+
+        //////////////////////////////////////////////////////////////////////////////////
+
+        namespace scalar
+        {
+            // dst[x] = sum(weights[k + radius] * src[clamp(x + k)]), for x in [begin, end).
+            static inline void convolveRow(const float* src, float* dst, int w, const float* weights, int radius, int begin, int end)
+            {
+                for (int x = begin; x < end; x++)
+                {
+                    float acc = 0.0f;
+
+                    for (int k = -radius; k <= radius; k++)
+                    {
+                        acc += weights[k + radius] * src[std::clamp(x + k, 0, w - 1)];
+                    }
+
+                    dst[x] = acc;
+                }
+            }
+
+            // dst[x] = sum(weights[k + radius] * src[clamp(y + k)][x]), for x in [begin, end).
+            static inline void convolveColumn(const float* src, float* dst, int w, int h, int y, const float* weights, int radius, int begin, int end)
+            {
+                for (int x = begin; x < end; x++)
+                {
+                    dst[x] = 0.0f;
+                }
+
+                for (int k = -radius; k <= radius; k++)
+                {
+                    const float* row = src + size_t(std::clamp(y + k, 0, h - 1)) * size_t(w);
+                    const float weight = weights[k + radius];
+
+                    for (int x = begin; x < end; x++)
+                    {
+                        dst[x] += weight * row[x];
+                    }
+                }
+            }
+
+            static inline void linearRGB2YCxCz(float* r, float* g, float* b, int begin, int end)
+            {
+                for (int i = begin; i < end; i++)
+                {
+                    const color3 YCxCz = color3::XYZ2YCxCz(color3::LinearRGB2XYZ(color3(r[i], g[i], b[i])));
+                    r[i] = YCxCz.x;
+                    g[i] = YCxCz.y;
+                    b[i] = YCxCz.z;
+                }
+            }
+
+            // Converts to linear RGB, clamps, and converts back to XYZ, divided by the reference illuminant.
+            static inline void YCxCz2ClampedXYZ(float* y, float* cx, float* cz, int begin, int end)
+            {
+                const color3 invReferenceIlluminant = INV_DEFAULT_ILLUMINANT;
+
+                for (int i = begin; i < end; i++)
+                {
+                    const color3 RGB = color3::clamp(color3::XYZ2LinearRGB(color3::YCxCz2XYZ(color3(y[i], cx[i], cz[i]))));
+                    const color3 XYZ = color3::LinearRGB2XYZ(RGB) * invReferenceIlluminant;
+                    y[i] = XYZ.x;
+                    cx[i] = XYZ.y;
+                    cz[i] = XYZ.z;
+                }
+            }
+        }
+
+#if FLIP_SIMD_X86
+
+        namespace sse41
+        {
+            FLIP_TARGET_SSE41 static inline void convolveRow(const float* src, float* dst, int w, const float* weights, int radius)
+            {
+                const int begin = std::min(radius, w);
+                const int end = w - radius;
+                scalar::convolveRow(src, dst, w, weights, radius, 0, begin);
+                int x = begin;
+
+                for (; x + 4 <= end; x += 4)
+                {
+                    const float* s = src + x - radius;
+                    __m128 acc = _mm_setzero_ps();
+
+                    for (int k = 0; k <= 2 * radius; k++)
+                    {
+                        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(s + k)));
+                    }
+
+                    _mm_storeu_ps(dst + x, acc);
+                }
+
+                scalar::convolveRow(src, dst, w, weights, radius, x, w);
+            }
+
+            FLIP_TARGET_SSE41 static inline void convolveColumn(const float* src, float* dst, int w, int h, int y, const float* weights, int radius)
+            {
+                const int end = w - w % 4;
+
+                for (int x = 0; x < end; x += 4)
+                {
+                    _mm_storeu_ps(dst + x, _mm_setzero_ps());
+                }
+
+                for (int k = -radius; k <= radius; k++)
+                {
+                    const float* row = src + size_t(std::clamp(y + k, 0, h - 1)) * size_t(w);
+                    const __m128 weight = _mm_set1_ps(weights[k + radius]);
+
+                    for (int x = 0; x < end; x += 4)
+                    {
+                        _mm_storeu_ps(dst + x, _mm_add_ps(_mm_loadu_ps(dst + x), _mm_mul_ps(weight, _mm_loadu_ps(row + x))));
+                    }
+                }
+
+                scalar::convolveColumn(src, dst, w, h, y, weights, radius, end, w);
+            }
+
+            FLIP_TARGET_SSE41 static inline void linearRGB2YCxCz(float* r, float* g, float* b, int count)
+            {
+                const __m128 a11 = _mm_set1_ps(10135552.0f / 24577794.0f);
+                const __m128 a12 = _mm_set1_ps(8788810.0f / 24577794.0f);
+                const __m128 a13 = _mm_set1_ps(4435075.0f / 24577794.0f);
+                const __m128 a21 = _mm_set1_ps(2613072.0f / 12288897.0f);
+                const __m128 a22 = _mm_set1_ps(8788810.0f / 12288897.0f);
+                const __m128 a23 = _mm_set1_ps(887015.0f / 12288897.0f);
+                const __m128 a31 = _mm_set1_ps(1425312.0f / 73733382.0f);
+                const __m128 a32 = _mm_set1_ps(8788810.0f / 73733382.0f);
+                const __m128 a33 = _mm_set1_ps(70074185.0f / 73733382.0f);
+                const color3 invReferenceIlluminant = INV_DEFAULT_ILLUMINANT;
+                const __m128 invX = _mm_set1_ps(invReferenceIlluminant.x);
+                const __m128 invY = _mm_set1_ps(invReferenceIlluminant.y);
+                const __m128 invZ = _mm_set1_ps(invReferenceIlluminant.z);
+                int i = 0;
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    const __m128 R = _mm_loadu_ps(r + i);
+                    const __m128 G = _mm_loadu_ps(g + i);
+                    const __m128 B = _mm_loadu_ps(b + i);
+                    const __m128 X = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a11, R), _mm_mul_ps(a12, G)), _mm_mul_ps(a13, B)), invX);
+                    const __m128 Y = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a21, R), _mm_mul_ps(a22, G)), _mm_mul_ps(a23, B)), invY);
+                    const __m128 Z = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a31, R), _mm_mul_ps(a32, G)), _mm_mul_ps(a33, B)), invZ);
+                    _mm_storeu_ps(r + i, _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(116.0f), Y), _mm_set1_ps(16.0f)));
+                    _mm_storeu_ps(g + i, _mm_mul_ps(_mm_set1_ps(500.0f), _mm_sub_ps(X, Y)));
+                    _mm_storeu_ps(b + i, _mm_mul_ps(_mm_set1_ps(200.0f), _mm_sub_ps(Y, Z)));
+                }
+
+                scalar::linearRGB2YCxCz(r, g, b, i, count);
+            }
+
+            FLIP_TARGET_SSE41 static inline void YCxCz2ClampedXYZ(float* y, float* cx, float* cz, int count)
+            {
+                const color3 referenceIlluminant = DEFAULT_ILLUMINANT;
+                const color3 invReferenceIlluminant = INV_DEFAULT_ILLUMINANT;
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 one = _mm_set1_ps(1.0f);
+                int i = 0;
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    // YCxCz to XYZ.
+                    const __m128 fy = _mm_div_ps(_mm_add_ps(_mm_loadu_ps(y + i), _mm_set1_ps(16.0f)), _mm_set1_ps(116.0f));
+                    const __m128 fx = _mm_add_ps(fy, _mm_div_ps(_mm_loadu_ps(cx + i), _mm_set1_ps(500.0f)));
+                    const __m128 fz = _mm_sub_ps(fy, _mm_div_ps(_mm_loadu_ps(cz + i), _mm_set1_ps(200.0f)));
+                    __m128 X = _mm_mul_ps(fx, _mm_set1_ps(referenceIlluminant.x));
+                    __m128 Y = _mm_mul_ps(fy, _mm_set1_ps(referenceIlluminant.y));
+                    __m128 Z = _mm_mul_ps(fz, _mm_set1_ps(referenceIlluminant.z));
+
+                    // XYZ to linear RGB, clamped to [0,1].
+                    const __m128 R = _mm_min_ps(one, _mm_max_ps(zero, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(3.241003275f), X), _mm_mul_ps(_mm_set1_ps(-1.537398934f), Y)), _mm_mul_ps(_mm_set1_ps(-0.498615861f), Z))));
+                    const __m128 G = _mm_min_ps(one, _mm_max_ps(zero, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.969224334f), X), _mm_mul_ps(_mm_set1_ps(1.875930071f), Y)), _mm_mul_ps(_mm_set1_ps(0.041554224f), Z))));
+                    const __m128 B = _mm_min_ps(one, _mm_max_ps(zero, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.055639423f), X), _mm_mul_ps(_mm_set1_ps(-0.204011202f), Y)), _mm_mul_ps(_mm_set1_ps(1.057148933f), Z))));
+
+                    // Linear RGB back to XYZ, divided by the reference illuminant.
+                    X = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(10135552.0f / 24577794.0f), R), _mm_mul_ps(_mm_set1_ps(8788810.0f / 24577794.0f), G)), _mm_mul_ps(_mm_set1_ps(4435075.0f / 24577794.0f), B));
+                    Y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(2613072.0f / 12288897.0f), R), _mm_mul_ps(_mm_set1_ps(8788810.0f / 12288897.0f), G)), _mm_mul_ps(_mm_set1_ps(887015.0f / 12288897.0f), B));
+                    Z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(1425312.0f / 73733382.0f), R), _mm_mul_ps(_mm_set1_ps(8788810.0f / 73733382.0f), G)), _mm_mul_ps(_mm_set1_ps(70074185.0f / 73733382.0f), B));
+                    _mm_storeu_ps(y + i, _mm_mul_ps(X, _mm_set1_ps(invReferenceIlluminant.x)));
+                    _mm_storeu_ps(cx + i, _mm_mul_ps(Y, _mm_set1_ps(invReferenceIlluminant.y)));
+                    _mm_storeu_ps(cz + i, _mm_mul_ps(Z, _mm_set1_ps(invReferenceIlluminant.z)));
+                }
+
+                scalar::YCxCz2ClampedXYZ(y, cx, cz, i, count);
+            }
+        }
+
+        namespace avx2
+        {
+            FLIP_TARGET_AVX2 static inline void convolveRow(const float* src, float* dst, int w, const float* weights, int radius)
+            {
+                const int begin = std::min(radius, w);
+                const int end = w - radius;
+                scalar::convolveRow(src, dst, w, weights, radius, 0, begin);
+                int x = begin;
+
+                for (; x + 8 <= end; x += 8)
+                {
+                    const float* s = src + x - radius;
+                    __m256 acc = _mm256_setzero_ps();
+
+                    for (int k = 0; k <= 2 * radius; k++)
+                    {
+                        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(s + k)));
+                    }
+
+                    _mm256_storeu_ps(dst + x, acc);
+                }
+
+                scalar::convolveRow(src, dst, w, weights, radius, x, w);
+            }
+
+            FLIP_TARGET_AVX2 static inline void convolveColumn(const float* src, float* dst, int w, int h, int y, const float* weights, int radius)
+            {
+                const int end = w - w % 8;
+
+                for (int x = 0; x < end; x += 8)
+                {
+                    _mm256_storeu_ps(dst + x, _mm256_setzero_ps());
+                }
+
+                for (int k = -radius; k <= radius; k++)
+                {
+                    const float* row = src + size_t(std::clamp(y + k, 0, h - 1)) * size_t(w);
+                    const __m256 weight = _mm256_set1_ps(weights[k + radius]);
+
+                    for (int x = 0; x < end; x += 8)
+                    {
+                        _mm256_storeu_ps(dst + x, _mm256_add_ps(_mm256_loadu_ps(dst + x), _mm256_mul_ps(weight, _mm256_loadu_ps(row + x))));
+                    }
+                }
+
+                scalar::convolveColumn(src, dst, w, h, y, weights, radius, end, w);
+            }
+
+            FLIP_TARGET_AVX2 static inline void linearRGB2YCxCz(float* r, float* g, float* b, int count)
+            {
+                const __m256 a11 = _mm256_set1_ps(10135552.0f / 24577794.0f);
+                const __m256 a12 = _mm256_set1_ps(8788810.0f / 24577794.0f);
+                const __m256 a13 = _mm256_set1_ps(4435075.0f / 24577794.0f);
+                const __m256 a21 = _mm256_set1_ps(2613072.0f / 12288897.0f);
+                const __m256 a22 = _mm256_set1_ps(8788810.0f / 12288897.0f);
+                const __m256 a23 = _mm256_set1_ps(887015.0f / 12288897.0f);
+                const __m256 a31 = _mm256_set1_ps(1425312.0f / 73733382.0f);
+                const __m256 a32 = _mm256_set1_ps(8788810.0f / 73733382.0f);
+                const __m256 a33 = _mm256_set1_ps(70074185.0f / 73733382.0f);
+                const color3 invReferenceIlluminant = INV_DEFAULT_ILLUMINANT;
+                const __m256 invX = _mm256_set1_ps(invReferenceIlluminant.x);
+                const __m256 invY = _mm256_set1_ps(invReferenceIlluminant.y);
+                const __m256 invZ = _mm256_set1_ps(invReferenceIlluminant.z);
+                int i = 0;
+
+                for (; i + 8 <= count; i += 8)
+                {
+                    const __m256 R = _mm256_loadu_ps(r + i);
+                    const __m256 G = _mm256_loadu_ps(g + i);
+                    const __m256 B = _mm256_loadu_ps(b + i);
+                    const __m256 X = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a11, R), _mm256_mul_ps(a12, G)), _mm256_mul_ps(a13, B)), invX);
+                    const __m256 Y = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a21, R), _mm256_mul_ps(a22, G)), _mm256_mul_ps(a23, B)), invY);
+                    const __m256 Z = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a31, R), _mm256_mul_ps(a32, G)), _mm256_mul_ps(a33, B)), invZ);
+                    _mm256_storeu_ps(r + i, _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(116.0f), Y), _mm256_set1_ps(16.0f)));
+                    _mm256_storeu_ps(g + i, _mm256_mul_ps(_mm256_set1_ps(500.0f), _mm256_sub_ps(X, Y)));
+                    _mm256_storeu_ps(b + i, _mm256_mul_ps(_mm256_set1_ps(200.0f), _mm256_sub_ps(Y, Z)));
+                }
+
+                scalar::linearRGB2YCxCz(r, g, b, i, count);
+            }
+
+            FLIP_TARGET_AVX2 static inline void YCxCz2ClampedXYZ(float* y, float* cx, float* cz, int count)
+            {
+                const color3 referenceIlluminant = DEFAULT_ILLUMINANT;
+                const color3 invReferenceIlluminant = INV_DEFAULT_ILLUMINANT;
+                const __m256 zero = _mm256_setzero_ps();
+                const __m256 one = _mm256_set1_ps(1.0f);
+                int i = 0;
+
+                for (; i + 8 <= count; i += 8)
+                {
+                    // YCxCz to XYZ.
+                    const __m256 fy = _mm256_div_ps(_mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_set1_ps(16.0f)), _mm256_set1_ps(116.0f));
+                    const __m256 fx = _mm256_add_ps(fy, _mm256_div_ps(_mm256_loadu_ps(cx + i), _mm256_set1_ps(500.0f)));
+                    const __m256 fz = _mm256_sub_ps(fy, _mm256_div_ps(_mm256_loadu_ps(cz + i), _mm256_set1_ps(200.0f)));
+                    __m256 X = _mm256_mul_ps(fx, _mm256_set1_ps(referenceIlluminant.x));
+                    __m256 Y = _mm256_mul_ps(fy, _mm256_set1_ps(referenceIlluminant.y));
+                    __m256 Z = _mm256_mul_ps(fz, _mm256_set1_ps(referenceIlluminant.z));
+
+                    // XYZ to linear RGB, clamped to [0,1].
+                    const __m256 R = _mm256_min_ps(one, _mm256_max_ps(zero, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(3.241003275f), X), _mm256_mul_ps(_mm256_set1_ps(-1.537398934f), Y)), _mm256_mul_ps(_mm256_set1_ps(-0.498615861f), Z))));
+                    const __m256 G = _mm256_min_ps(one, _mm256_max_ps(zero, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-0.969224334f), X), _mm256_mul_ps(_mm256_set1_ps(1.875930071f), Y)), _mm256_mul_ps(_mm256_set1_ps(0.041554224f), Z))));
+                    const __m256 B = _mm256_min_ps(one, _mm256_max_ps(zero, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.055639423f), X), _mm256_mul_ps(_mm256_set1_ps(-0.204011202f), Y)), _mm256_mul_ps(_mm256_set1_ps(1.057148933f), Z))));
+
+                    // Linear RGB back to XYZ, divided by the reference illuminant.
+                    X = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(10135552.0f / 24577794.0f), R), _mm256_mul_ps(_mm256_set1_ps(8788810.0f / 24577794.0f), G)), _mm256_mul_ps(_mm256_set1_ps(4435075.0f / 24577794.0f), B));
+                    Y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(2613072.0f / 12288897.0f), R), _mm256_mul_ps(_mm256_set1_ps(8788810.0f / 12288897.0f), G)), _mm256_mul_ps(_mm256_set1_ps(887015.0f / 12288897.0f), B));
+                    Z = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(1425312.0f / 73733382.0f), R), _mm256_mul_ps(_mm256_set1_ps(8788810.0f / 73733382.0f), G)), _mm256_mul_ps(_mm256_set1_ps(70074185.0f / 73733382.0f), B));
+                    _mm256_storeu_ps(y + i, _mm256_mul_ps(X, _mm256_set1_ps(invReferenceIlluminant.x)));
+                    _mm256_storeu_ps(cx + i, _mm256_mul_ps(Y, _mm256_set1_ps(invReferenceIlluminant.y)));
+                    _mm256_storeu_ps(cz + i, _mm256_mul_ps(Z, _mm256_set1_ps(invReferenceIlluminant.z)));
+                }
+
+                scalar::YCxCz2ClampedXYZ(y, cx, cz, i, count);
+            }
+        }
+
+#endif
+
+        //////////////////////////////////////////////////////////////////////////////////
+
+        // Convolves one row with a 1D filter of 2 * radius + 1 weights, clamping at the borders.
+        static inline void convolveRow(const float* src, float* dst, int w, const float* weights, int radius)
+        {
+#if FLIP_SIMD_X86
+            switch (getLevel())
+            {
+            case Level::AVX2:
+                avx2::convolveRow(src, dst, w, weights, radius);
+                return;
+            case Level::SSE41:
+                sse41::convolveRow(src, dst, w, weights, radius);
+                return;
+            default:
+                break;
+            }
+#endif
+            scalar::convolveRow(src, dst, w, weights, radius, 0, w);
+        }
+
+        // Computes row y of the vertical convolution of the w * h plane src, clamping at the borders.
+        static inline void convolveColumn(const float* src, float* dst, int w, int h, int y, const float* weights, int radius)
+        {
+#if FLIP_SIMD_X86
+            switch (getLevel())
+            {
+            case Level::AVX2:
+                avx2::convolveColumn(src, dst, w, h, y, weights, radius);
+                return;
+            case Level::SSE41:
+                sse41::convolveColumn(src, dst, w, h, y, weights, radius);
+                return;
+            default:
+                break;
+            }
+#endif
+            scalar::convolveColumn(src, dst, w, h, y, weights, radius, 0, w);
+        }
+
+        // In place conversion of count pixels from linear RGB to YCxCz.
+        static inline void linearRGB2YCxCz(float* r, float* g, float* b, int count)
+        {
+#if FLIP_SIMD_X86
+            switch (getLevel())
+            {
+            case Level::AVX2:
+                avx2::linearRGB2YCxCz(r, g, b, count);
+                return;
+            case Level::SSE41:
+                sse41::linearRGB2YCxCz(r, g, b, count);
+                return;
+            default:
+                break;
+            }
+#endif
+            scalar::linearRGB2YCxCz(r, g, b, 0, count);
+        }
+
+        // In place conversion of count pixels from YCxCz to the clamped XYZ values that feed color3::XYZ2CIELab,
+        // already divided by the reference illuminant (only the cube roots remain to be computed).
+        static inline void YCxCz2ClampedXYZ(float* y, float* cx, float* cz, int count)
+        {
+#if FLIP_SIMD_X86
+            switch (getLevel())
+            {
+            case Level::AVX2:
+                avx2::YCxCz2ClampedXYZ(y, cx, cz, count);
+                return;
+            case Level::SSE41:
+                sse41::YCxCz2ClampedXYZ(y, cx, cz, count);
+                return;
+            default:
+                break;
+            }
+#endif
+            scalar::YCxCz2ClampedXYZ(y, cx, cz, 0, count);
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////
+
+#if FLIP_SIMD_X86
+
+        namespace check
+        {
+            // Pseudo-random values in [0,1), reproducible.
+            static inline std::vector<float> makeValues(size_t count, uint32_t seed)
+            {
+                std::vector<float> result(count);
+
+                for (auto& value : result)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                    value = float(seed >> 8) / float(1u << 24);
+                }
+
+                return result;
+            }
+
+            static inline bool areClose(const std::vector<float>& lhs, const std::vector<float>& rhs, float tolerance)
+            {
+                for (size_t i = 0; i < lhs.size(); i++)
+                {
+                    if (std::abs(lhs[i] - rhs[i]) > tolerance * std::max(1.0f, std::abs(lhs[i])))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            // Runs every kernel of one instruction set, and checks the results against the scalar ones.
+            template<typename ConvolveRowT, typename ConvolveColumnT, typename RGB2YCxCzT, typename YCxCz2XYZT>
+            static inline bool checkLevel(ConvolveRowT convolveRowFunc, ConvolveColumnT convolveColumnFunc, RGB2YCxCzT rgb2YCxCzFunc, YCxCz2XYZT yCxCz2XYZFunc, float tolerance)
+            {
+                // Odd sizes, so that the scalar tails are processed as well.
+                const int w = 67;
+                const int h = 7;
+                const int radius = 3;
+                const std::vector<float> weights = makeValues(2 * radius + 1, 1u);
+                const std::vector<float> src = makeValues(size_t(w) * size_t(h), 2u);
+                std::vector<float> expected(static_cast<size_t>(w));
+                std::vector<float> actual(static_cast<size_t>(w));
+
+                scalar::convolveRow(src.data(), expected.data(), w, weights.data(), radius, 0, w);
+                convolveRowFunc(src.data(), actual.data(), w, weights.data(), radius);
+
+                if (!areClose(expected, actual, tolerance))
+                {
+                    return false;
+                }
+
+                for (int y = 0; y < h; y++)
+                {
+                    scalar::convolveColumn(src.data(), expected.data(), w, h, y, weights.data(), radius, 0, w);
+                    convolveColumnFunc(src.data(), actual.data(), w, h, y, weights.data(), radius);
+
+                    if (!areClose(expected, actual, tolerance))
+                    {
+                        return false;
+                    }
+                }
+
+                std::vector<float> expectedPlanes[3] = { makeValues(size_t(w), 3u), makeValues(size_t(w), 4u), makeValues(size_t(w), 5u) };
+                std::vector<float> actualPlanes[3] = { expectedPlanes[0], expectedPlanes[1], expectedPlanes[2] };
+                scalar::linearRGB2YCxCz(expectedPlanes[0].data(), expectedPlanes[1].data(), expectedPlanes[2].data(), 0, w);
+                rgb2YCxCzFunc(actualPlanes[0].data(), actualPlanes[1].data(), actualPlanes[2].data(), w);
+
+                for (int c = 0; c < 3; c++)
+                {
+                    if (!areClose(expectedPlanes[c], actualPlanes[c], tolerance))
+                    {
+                        return false;
+                    }
+
+                    actualPlanes[c] = expectedPlanes[c];
+                }
+
+                scalar::YCxCz2ClampedXYZ(expectedPlanes[0].data(), expectedPlanes[1].data(), expectedPlanes[2].data(), 0, w);
+                yCxCz2XYZFunc(actualPlanes[0].data(), actualPlanes[1].data(), actualPlanes[2].data(), w);
+
+                for (int c = 0; c < 3; c++)
+                {
+                    if (!areClose(expectedPlanes[c], actualPlanes[c], tolerance))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+        }
+
+#endif
+
+        // Checks that the SSE4.1 and AVX2 kernels supported by the CPU give the same results as the scalar ones,
+        // within the given relative tolerance.
+        static inline bool checkKernels(float tolerance = 1.0e-4f)
+        {
+#if FLIP_SIMD_X86
+            const Level level = getLevel();
+
+            if (level >= Level::SSE41
+                && !check::checkLevel(sse41::convolveRow, sse41::convolveColumn, sse41::linearRGB2YCxCz, sse41::YCxCz2ClampedXYZ, tolerance))
+            {
+                return false;
+            }
+
+            if (level >= Level::AVX2
+                && !check::checkLevel(avx2::convolveRow, avx2::convolveColumn, avx2::linearRGB2YCxCz, avx2::YCxCz2ClampedXYZ, tolerance))
+            {
+                return false;
+            }
+#endif
+            return true;
+        }
+    }
+}
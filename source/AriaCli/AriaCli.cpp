@@ -0,0 +1,221 @@
+#include "AriaCli.hpp"
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <wx/arrstr.h>
+#include <wx/image.h>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+wxIMPLEMENT_APP_CONSOLE( aria::AriaCli );
+
+namespace aria
+{
+	//*********************************************************************************************
+
+	namespace cli
+	{
+		namespace lg
+		{
+			static const wxString Renderers{ wxT( "renderers" ) };
+			static const wxString Categories{ wxT( "categories" ) };
+			static const wxString Statuses{ wxT( "statuses" ) };
+			static const wxString Outdated{ wxT( "outdated" ) };
+			static const wxString Jobs{ wxT( "jobs" ) };
+			static const wxString DiffWorkers{ wxT( "diff_workers" ) };
+		}
+
+		namespace st
+		{
+			static const wxString Renderers{ wxT( "r" ) };
+			static const wxString Categories{ wxT( "ca" ) };
+			static const wxString Statuses{ wxT( "s" ) };
+			static const wxString Outdated{ wxT( "o" ) };
+			static const wxString Jobs{ wxT( "j" ) };
+			static const wxString DiffWorkers{ wxT( "dw" ) };
+		}
+
+		namespace dc
+		{
+			static const wxString Renderers{ _( "Comma separated list of the renderers to run (default: all)." ) };
+			static const wxString Categories{ _( "Comma separated list of the categories to run (default: all)." ) };
+			static const wxString Statuses{ _( "Comma separated list of the latest statuses to run (not_run, negligible, acceptable, unacceptable, unprocessed, crashed)." ) };
+			static const wxString Outdated{ _( "Only runs the outdated and never run tests." ) };
+			static const wxString Jobs{ _( "Maximum count of simultaneous test runs (default: the config's concurrent runs)." ) };
+			static const wxString DiffWorkers{ _( "Count of results comparison threads (default: the config's comparison threads)." ) };
+		}
+
+		static void fillParser( wxCmdLineParser & parser )
+		{
+			parser.AddOption( st::Renderers
+				, lg::Renderers
+				, dc::Renderers
+				, wxCMD_LINE_VAL_STRING, 0 );
+			parser.AddOption( st::Categories
+				, lg::Categories
+				, dc::Categories
+				, wxCMD_LINE_VAL_STRING, 0 );
+			parser.AddOption( st::Statuses
+				, lg::Statuses
+				, dc::Statuses
+				, wxCMD_LINE_VAL_STRING, 0 );
+			parser.AddSwitch( st::Outdated
+				, lg::Outdated
+				, dc::Outdated );
+			parser.AddOption( st::Jobs
+				, lg::Jobs
+				, dc::Jobs
+				, wxCMD_LINE_VAL_STRING, 0 );
+			parser.AddOption( st::DiffWorkers
+				, lg::DiffWorkers
+				, dc::DiffWorkers
+				, wxCMD_LINE_VAL_STRING, 0 );
+		}
+
+		static std::set< std::string > getNames( Options const & options
+			, wxString const & option )
+		{
+			std::set< std::string > result;
+
+			for ( auto & name : wxSplit( options.getString( option, false ), wxT( ',' ) ) )
+			{
+				name.Trim( true ).Trim( false );
+
+				if ( !name.empty() )
+				{
+					result.insert( makeStdString( name ) );
+				}
+			}
+
+			return result;
+		}
+
+		static uint32_t getCount( Options const & options
+			, wxString const & option
+			, uint32_t defaultValue )
+		{
+			unsigned long value{};
+
+			if ( options.getString( option, false ).ToULong( &value ) )
+			{
+				return uint32_t( value );
+			}
+
+			return defaultValue;
+		}
+	}
+
+	//*********************************************************************************************
+
+	OptionsPtr AriaCli::doParseCommandLine()
+	{
+		wxAppConsole::SetAppName( wxT( "aria-cli" ) );
+		wxAppConsole::SetVendorName( wxT( "dragonjoker" ) );
+
+		try
+		{
+			return std::make_unique< Options >( m_factory
+				, m_pluginsLibs
+				, wxAppConsole::argc
+				, wxAppConsole::argv
+				, cli::fillParser );
+		}
+		catch ( bool help )
+		{
+			if ( help )
+			{
+				m_result = TestsRunner::eSuccess;
+			}
+
+			return nullptr;
+		}
+	}
+
+	bool AriaCli::doGetFilter( RunFilter & filter )const
+	{
+		filter.renderers = cli::getNames( *m_options, cli::lg::Renderers );
+		filter.categories = cli::getNames( *m_options, cli::lg::Categories );
+		filter.outdated = m_options->has( cli::lg::Outdated );
+
+		for ( auto & name : cli::getNames( *m_options, cli::lg::Statuses ) )
+		{
+			auto status = TestStatus::eNotRun;
+
+			while ( status <= TestStatus::eCrashed
+				&& getName( status ) != name )
+			{
+				status = TestStatus( uint32_t( status ) + 1u );
+			}
+
+			if ( status > TestStatus::eCrashed )
+			{
+				wxLogError( wxString{} << "Unknown test status: " << name );
+				return false;
+			}
+
+			filter.statuses.insert( status );
+		}
+
+		return true;
+	}
+
+	bool AriaCli::OnInit()
+	{
+		wxConvCurrent = &wxConvUTF8;
+		m_log = std::make_unique< wxLogStderr >();
+		wxLog::SetActiveTarget( m_log.get() );
+		m_options = doParseCommandLine();
+		RunFilter filter;
+
+		if ( !m_options
+			|| !doGetFilter( filter ) )
+		{
+			// OnRun returns the error code.
+			return true;
+		}
+
+		if ( !m_options->hasPlugin() )
+		{
+			wxLogError( "No tests configuration selected, use the --config option." );
+			return true;
+		}
+
+		wxInitAllImageHandlers();
+		auto & plugin = *m_options->getPlugin();
+		m_runner = std::make_unique< TestsRunner >( plugin
+			, std::move( filter )
+			, cli::getCount( *m_options, cli::lg::Jobs, plugin.config.maxConcurrentRuns )
+			, cli::getCount( *m_options, cli::lg::DiffWorkers, plugin.config.diffWorkers )
+			, [this]( TestsRunner::Result result )
+			{
+				m_result = result;
+				// There is no main window, the main loop is left when the runs are over.
+				ExitMainLoop();
+			} );
+		CallAfter( [this]()
+			{
+				m_runner->start();
+			} );
+		return true;
+	}
+
+	int AriaCli::OnRun()
+	{
+		if ( m_runner )
+		{
+			wxAppConsole::OnRun();
+		}
+
+		return m_result;
+	}
+
+	int AriaCli::OnExit()
+	{
+		m_runner.reset();
+		m_options.reset();
+		wxImage::CleanUpHandlers();
+		wxLog::SetActiveTarget( nullptr );
+		m_pluginsLibs.clear();
+		return wxAppConsole::OnExit();
+	}
+
+	//*********************************************************************************************
+}
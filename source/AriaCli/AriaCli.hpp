@@ -0,0 +1,42 @@
+/*
+See LICENSE file in root folder
+*/
+#ifndef ___ARIA_AriaCli_HPP___
+#define ___ARIA_AriaCli_HPP___
+
+#include "TestsRunner.hpp"
+
+#include <AriaLib/Options.hpp>
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <wx/app.h>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria
+{
+	// Headless tests runner, for continuous integration.
+	// It is a console application, so it doesn't need any display.
+	class AriaCli
+		: public wxAppConsole
+	{
+	private:
+		OptionsPtr doParseCommandLine();
+		bool doGetFilter( RunFilter & filter )const;
+
+		bool OnInit()override;
+		int OnRun()override;
+		int OnExit()override;
+
+	private:
+		PluginFactory m_factory;
+		std::vector< PluginLib > m_pluginsLibs;
+		std::unique_ptr< wxLog > m_log;
+		OptionsPtr m_options;
+		std::unique_ptr< TestsRunner > m_runner;
+		int m_result{ TestsRunner::eError };
+	};
+}
+
+wxDECLARE_APP( aria::AriaCli );
+
+#endif
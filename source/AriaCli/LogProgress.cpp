@@ -0,0 +1,76 @@
+#include "LogProgress.hpp"
+
+namespace aria
+{
+	//*********************************************************************************************
+
+	namespace progress
+	{
+		// At most one progress line per second, so that the CI logs stay readable.
+		static auto constexpr logPeriod = std::chrono::seconds{ 1 };
+	}
+
+	//*********************************************************************************************
+
+	void LogProgress::setTitle( wxString const & title )
+	{
+		wxLogMessage( title );
+	}
+
+	int LogProgress::getRange()const
+	{
+		return m_range;
+	}
+
+	void LogProgress::setRange( int range )
+	{
+		m_range = range;
+	}
+
+	void LogProgress::update( int index )
+	{
+	}
+
+	void LogProgress::update( int index
+		, wxString const & message )
+	{
+		// The progress steps are frequent, only the new messages are worth logging,
+		// and not more often than the log period, except for the last step.
+		auto now = std::chrono::steady_clock::now();
+
+		if ( message == m_message
+			|| ( index < m_range && now - m_lastLog < progress::logPeriod ) )
+		{
+			return;
+		}
+
+		m_message = message;
+		m_lastLog = now;
+		auto line = message;
+		line.Replace( wxT( "\n" ), wxT( " - " ) );
+		wxLogMessage( wxString{} << "[" << index << "/" << m_range << "] " << line );
+	}
+
+	void LogProgress::fit()
+	{
+	}
+
+	bool LogProgress::select( wxString const & title
+		, wxString const & message
+		, wxArrayString const & choices
+		, wxArrayInt & selections )
+	{
+		wxLogMessage( wxString{} << title << ": selecting all the choices." );
+		selections.clear();
+
+		for ( size_t i = 0u; i < choices.size(); ++i )
+		{
+			wxLogMessage( wxString{} << "  " << choices[i] );
+			selections.push_back( int( i ) );
+		}
+
+		return true;
+	}
+
+	//*********************************************************************************************
+}
@@ -0,0 +1,40 @@
+/*
+See LICENSE file in root folder
+*/
+#ifndef ___ARIA_LogProgress_HPP___
+#define ___ARIA_LogProgress_HPP___
+
+#include <AriaLib/Progress.hpp>
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <chrono>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria
+{
+	// Reports the database operations progress in the log.
+	// Nobody can answer the selections, so all the choices are selected.
+	class LogProgress
+		: public Progress
+	{
+	public:
+		void setTitle( wxString const & title )override;
+		int getRange()const override;
+		void setRange( int range )override;
+		void update( int index )override;
+		void update( int index
+			, wxString const & message )override;
+		void fit()override;
+		bool select( wxString const & title
+			, wxString const & message
+			, wxArrayString const & choices
+			, wxArrayInt & selections )override;
+
+	private:
+		int m_range{ 1 };
+		wxString m_message;
+		std::chrono::steady_clock::time_point m_lastLog{};
+	};
+}
+
+#endif
@@ -0,0 +1,341 @@
+#include "TestsRunner.hpp"
+#include "LogProgress.hpp"
+
+#include <AriaLib/Plugin.hpp>
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <wx/timer.h>
+
+#include <iostream>
+#include <limits>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+namespace aria
+{
+	//*********************************************************************************************
+
+	namespace runner
+	{
+		enum ID
+		{
+			eID_TIMER_KILL_RUN,
+		};
+
+		template< typename MapT >
+		static void checkNames( std::set< std::string > const & names
+			, MapT const & known
+			, std::string const & type )
+		{
+			for ( auto & name : names )
+			{
+				if ( known.find( name ) == known.end() )
+				{
+					throw std::runtime_error{ "Unknown " + type + ": " + name };
+				}
+			}
+		}
+
+		static bool isFailure( TestStatus status )
+		{
+			return status == TestStatus::eUnacceptable
+				|| status == TestStatus::eCrashed
+				|| status == TestStatus::eUnprocessed;
+		}
+	}
+
+	//*********************************************************************************************
+
+	TestsRunner::TestProcess::TestProcess( wxEvtHandler * runner
+		, int flags )
+		: wxProcess{ flags }
+		, m_runner{ runner }
+	{
+	}
+
+	void TestsRunner::TestProcess::OnTerminate( int pid, int status )
+	{
+		auto event = new wxProcessEvent{ wxID_ANY, pid, status };
+		m_runner->QueueEvent( event );
+	}
+
+	//*********************************************************************************************
+
+	TestsRunner::TestsRunner( Plugin & plugin
+		, RunFilter filter
+		, uint32_t maxRuns
+		, uint32_t diffWorkers
+		, OnEnd onEnd )
+		: m_plugin{ plugin }
+		, m_filter{ std::move( filter ) }
+		, m_maxRuns{ std::max( 1u, maxRuns ) }
+		, m_onEnd{ std::move( onEnd ) }
+		, m_database{ m_plugin, m_fileSystem }
+		, m_runs{ m_database }
+		, m_counts{ m_plugin }
+		, m_diffWorkers{ std::max( 1u, diffWorkers ) }
+		, m_timerKillRun{ new wxTimer{ this, runner::eID_TIMER_KILL_RUN } }
+		, m_runsFlusher{ *this, m_database }
+	{
+		Bind( wxEVT_TIMER
+			, &TestsRunner::onKillRunTimer
+			, this
+			, runner::eID_TIMER_KILL_RUN );
+		Connect( wxEVT_END_PROCESS
+			, wxProcessEventHandler( TestsRunner::onProcessEnd )
+			, nullptr
+			, this );
+	}
+
+	TestsRunner::~TestsRunner()
+	{
+		m_diffWorkers.stop();
+		m_fileSystem.cleanup();
+		m_timerKillRun->Stop();
+		delete m_timerKillRun;
+
+		for ( auto & running : m_running )
+		{
+			running.second.process->Disconnect( wxEVT_END_PROCESS );
+		}
+
+		m_running.clear();
+	}
+
+	void TestsRunner::start()
+	{
+		try
+		{
+			LogProgress progress;
+			int index = 0;
+			m_database.initialise( progress, index );
+			m_fileSystem.initialise();
+			doListTests();
+		}
+		catch ( std::exception & exc )
+		{
+			wxLogError( wxString{} << "Couldn't load the tests: " << exc.what() );
+			m_onEnd( eError );
+			return;
+		}
+
+		m_selected = uint32_t( m_pending.size() );
+		std::cout << m_selected << " tests selected." << std::endl;
+		doProcessTests();
+	}
+
+	bool TestsRunner::doIsSelected( DatabaseTest const & test )const
+	{
+		if ( !m_filter.statuses.empty()
+			&& m_filter.statuses.find( test.getStatus() ) == m_filter.statuses.end() )
+		{
+			return false;
+		}
+
+		// Same selection as the "Run outdated tests" menus: the never run tests are outdated.
+		return !m_filter.outdated
+			|| m_plugin.isOutOfDate( *test )
+			|| test.getStatus() == TestStatus::eNotRun;
+	}
+
+	void TestsRunner::doListTests()
+	{
+		// A misspelt filter must not silently select nothing.
+		runner::checkNames( m_filter.renderers, m_database.getRenderers(), "renderer" );
+		runner::checkNames( m_filter.categories, m_database.getCategories(), "category" );
+		m_database.listTests( m_tests );
+		m_plugin.updateEngineRefDate();
+
+		for ( auto & renderer : m_database.getRenderers() )
+		{
+			if ( !m_filter.renderers.empty()
+				&& m_filter.renderers.find( renderer.first ) == m_filter.renderers.end() )
+			{
+				continue;
+			}
+
+			auto & rendRuns = m_runs.addRenderer( renderer.second.get() );
+			auto & rendCounts = m_counts.addRenderer( renderer.second.get() );
+
+			for ( auto & category : m_tests )
+			{
+				if ( !m_filter.categories.empty()
+					&& m_filter.categories.find( category.first->name ) == m_filter.categories.end() )
+				{
+					continue;
+				}
+
+				// The counts follow the loaded tests, so that the runs statuses updates can be counted.
+				auto & catCounts = rendCounts.addCategory( category.first, category.second );
+				catCounts.clear();
+
+				for ( auto run : m_database.listLatestRuns( renderer.second.get()
+					, category.first
+					, category.second
+					, rendRuns ) )
+				{
+					catCounts.addTest( *run );
+
+					if ( doIsSelected( *run ) )
+					{
+						m_pending.push_back( run );
+					}
+				}
+			}
+		}
+	}
+
+	void TestsRunner::doProcessTests()
+	{
+		while ( m_running.size() < m_maxRuns
+			&& !m_pending.empty() )
+		{
+			auto test = m_pending.front();
+			m_pending.pop_front();
+			doLaunchTest( *test );
+		}
+
+		if ( m_pending.empty()
+			&& m_running.empty()
+			&& m_comparing == 0u )
+		{
+			doEnd();
+		}
+	}
+
+	bool TestsRunner::doLaunchTest( DatabaseTest & test )
+	{
+		auto process = std::make_unique< TestProcess >( this, wxPROCESS_DEFAULT );
+		auto result = m_plugin.runTest( process.get()
+			, test
+			, test.getRenderer()->name );
+
+		if ( result == 0 )
+		{
+			wxLogError( wxString{} << "Couldn't launch the test " << test.getName() );
+			// Not stored in the database, but it must fail the run.
+			++m_results[TestStatus::eCrashed];
+			++m_done;
+			return false;
+		}
+
+		m_running.emplace( result
+			, Running{ std::move( process )
+				, &test
+				, std::chrono::steady_clock::now() } );
+
+		if ( !m_timerKillRun->IsRunning() )
+		{
+			m_timerKillRun->Start( testrun::timerKillPeriod );
+		}
+
+		return true;
+	}
+
+	void TestsRunner::doReport( DatabaseTest const & test )
+	{
+		++m_results[test.getStatus()];
+		std::cout << "[" << ++m_done << "/" << m_selected << "] "
+			<< test.getRenderer()->name
+			<< " - " << test.getCategory()->name
+			<< " - " << test.getName()
+			<< ": " << getName( test.getStatus() ) << std::endl;
+	}
+
+	void TestsRunner::doEnd()
+	{
+		m_timerKillRun->Stop();
+
+		if ( !m_runsFlusher.flush() )
+		{
+			m_onEnd( eError );
+			return;
+		}
+
+		auto result = eSuccess;
+		std::cout << "Summary: " << m_done << " tests run." << std::endl;
+
+		for ( auto & status : m_results )
+		{
+			std::cout << "  " << getName( status.first ) << ": " << status.second << std::endl;
+
+			if ( runner::isFailure( status.first ) )
+			{
+				result = eFailure;
+			}
+		}
+
+		m_onEnd( result );
+	}
+
+	void TestsRunner::onTestRunEnd( DatabaseTest & test
+		, int status )
+	{
+		if ( status < 0 && status != std::numeric_limits< int >::max() )
+		{
+			wxLogError( wxString() << "Test run failed (" << status << ")" );
+		}
+
+		auto times = m_database.processTestOutputTimes( testrun::getTimesFile( m_plugin, test ) );
+		++m_comparing;
+		m_diffWorkers.push( testrun::getDiffOptions( m_plugin, test )
+			, [this, &test, times]( DiffWorkerPool::Result const & result )
+			{
+				using wxAsyncCompareEndCallback = std::function< void() >;
+				using wxAsyncCompareEnd = wxAsyncMethodCallEventFunctor< wxAsyncCompareEndCallback >;
+				QueueEvent( new wxAsyncCompareEnd{ this
+					, [this, &test, times, result]()
+					{
+						onTestCompareEnd( test, times, result );
+					} } );
+			} );
+		// The comparison happens in background, the freed launcher slot can be used right away.
+		doProcessTests();
+	}
+
+	void TestsRunner::onTestCompareEnd( DatabaseTest & test
+		, TestTimes const & times
+		, DiffWorkerPool::Result const & result )
+	{
+		--m_comparing;
+		testrun::queueNewRun( test, times, result );
+		m_runsFlusher.queue();
+		doReport( test );
+		doProcessTests();
+	}
+
+	void TestsRunner::onProcessEnd( wxProcessEvent & evt )
+	{
+		auto it = m_running.find( evt.GetPid() );
+
+		if ( it == m_running.end() )
+		{
+			evt.Skip();
+			return;
+		}
+
+		auto & test = *it->second.test;
+		m_running.erase( it );
+		onTestRunEnd( test, evt.GetExitCode() );
+	}
+
+	void TestsRunner::onKillRunTimer( wxTimerEvent & evt )
+	{
+		if ( m_running.empty() )
+		{
+			m_timerKillRun->Stop();
+			return;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+
+		for ( auto & running : m_running )
+		{
+			testrun::killIfTimedOut( running.first
+				, running.second.start
+				, now
+				, running.second.test->getName() );
+		}
+	}
+
+	//*********************************************************************************************
+}
@@ -0,0 +1,124 @@
+/*
+See LICENSE file in root folder
+*/
+#ifndef ___ARIA_TestsRunner_HPP___
+#define ___ARIA_TestsRunner_HPP___
+
+#include "DiffWorkerPool.hpp"
+#include "TestRunHelpers.hpp"
+
+#include <AriaLib/TestsCounts.hpp>
+#include <AriaLib/Database/DatabaseTest.hpp>
+#include <AriaLib/Database/TestDatabase.hpp>
+#include <AriaLib/FileSystem/FileSystem.hpp>
+
+#include <AriaLib/BeginExternHeaderGuard.hpp>
+#include <wx/event.h>
+#include <wx/process.h>
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <map>
+#include <set>
+#include <AriaLib/EndExternHeaderGuard.hpp>
+
+class wxTimer;
+class wxTimerEvent;
+
+namespace aria
+{
+	struct RunFilter
+	{
+		// Empty sets select everything.
+		std::set< std::string > renderers;
+		std::set< std::string > categories;
+		std::set< TestStatus > statuses;
+		bool outdated{};
+	};
+
+	// Runs the filtered tests, compares their outputs and stores the results in the database, without any UI.
+	class TestsRunner
+		: public wxEvtHandler
+	{
+	public:
+		enum Result : int
+		{
+			eSuccess = 0,
+			// At least one test is unacceptable, crashed, or couldn't be compared.
+			eFailure = 1,
+			eError = 2,
+		};
+		using OnEnd = std::function< void( Result ) >;
+
+	private:
+		class TestProcess
+			: public wxProcess
+		{
+		public:
+			TestProcess( wxEvtHandler * runner
+				, int flags );
+
+			void OnTerminate( int pid, int status )override;
+
+		private:
+			wxEvtHandler * m_runner;
+		};
+
+		struct Running
+		{
+			std::unique_ptr< wxProcess > process{};
+			DatabaseTest * test{};
+			std::chrono::steady_clock::time_point start{};
+		};
+
+	public:
+		TestsRunner( Plugin & plugin
+			, RunFilter filter
+			, uint32_t maxRuns
+			, uint32_t diffWorkers
+			, OnEnd onEnd );
+		~TestsRunner()override;
+
+		// Must be called from the event loop, since the runs end are notified through it.
+		void start();
+
+	private:
+		bool doIsSelected( DatabaseTest const & test )const;
+		void doListTests();
+		void doProcessTests();
+		bool doLaunchTest( DatabaseTest & test );
+		void doReport( DatabaseTest const & test );
+		void doEnd();
+
+		void onTestRunEnd( DatabaseTest & test
+			, int status );
+		void onTestCompareEnd( DatabaseTest & test
+			, TestTimes const & times
+			, DiffWorkerPool::Result const & result );
+		void onProcessEnd( wxProcessEvent & evt );
+		void onKillRunTimer( wxTimerEvent & evt );
+
+	private:
+		Plugin & m_plugin;
+		RunFilter m_filter;
+		uint32_t m_maxRuns;
+		OnEnd m_onEnd;
+		FileSystem m_fileSystem;
+		TestDatabase m_database;
+		TestMap m_tests;
+		AllTestRuns m_runs;
+		AllTestsCounts m_counts;
+		DiffWorkerPool m_diffWorkers;
+		wxTimer * m_timerKillRun;
+		RunsFlusher m_runsFlusher;
+		std::list< DatabaseTest * > m_pending;
+		std::map< long, Running > m_running;
+		uint32_t m_comparing{};
+		uint32_t m_selected{};
+		uint32_t m_done{};
+		std::map< TestStatus, uint32_t > m_results;
+	};
+}
+
+#endif
@@ -90,37 +90,44 @@ namespace aria
 		, db::DateTime const & runDate
 		, TestTimes const & times )
 	{
-		auto & plugin = *m_database->m_plugin;
-		auto rawStatus = status;
-		auto newStatus = rawStatus;
+		doUpdateNewRun( status, runDate, times );
+		m_database->insertRun( m_test );
 
 		if ( m_test.test->ignoreResult )
 		{
-			newStatus = TestStatus::eNegligible;
+			updateReference( status );
 		}
+	}
 
-		m_test.runDate = runDate;
-		m_test.times = times;
-		assert( m_test.runDate.IsValid() );
-		plugin.updateEngineRefDate();
-		m_test.engineDate = plugin.getEngineRefDate();
-		assert( m_test.engineDate.IsValid() );
-		m_test.testDate = m_database->getPlugin().getTestDate( m_test );
-		assert( m_test.testDate.IsValid() );
-		updateStatusNW( newStatus );
-		m_database->insertRun( m_test );
+	void DatabaseTest::createNewRun( wxFileName const & match
+		, TestTimes const & times )
+	{
+		auto path = match.GetPath();
+		createNewRun( aria::getStatus( makeStdString( wxFileName{ path }.GetName() ) )
+			, getFileDate( match )
+			, times );
+	}
 
+	void DatabaseTest::queueNewRun( TestStatus status
+		, db::DateTime const & runDate
+		, TestTimes const & times )
+	{
 		if ( m_test.test->ignoreResult )
 		{
-			updateReference( rawStatus );
+			// The reference is updated from the result file, which is only moved when the run is inserted.
+			createNewRun( status, runDate, times );
+			return;
 		}
+
+		doUpdateNewRun( status, runDate, times );
+		m_database->queueRun( *this );
 	}
 
-	void DatabaseTest::createNewRun( wxFileName const & match
+	void DatabaseTest::queueNewRun( wxFileName const & match
 		, TestTimes const & times )
 	{
 		auto path = match.GetPath();
-		createNewRun( aria::getStatus( makeStdString( wxFileName{ path }.GetName() ) )
+		queueNewRun( aria::getStatus( makeStdString( wxFileName{ path }.GetName() ) )
 			, getFileDate( match )
 			, times );
 	}
@@ -228,6 +235,29 @@ namespace aria
 			, status );
 	}
 
+	void DatabaseTest::doUpdateNewRun( TestStatus status
+		, db::DateTime const & runDate
+		, TestTimes const & times )
+	{
+		auto & plugin = *m_database->m_plugin;
+		auto newStatus = status;
+
+		if ( m_test.test->ignoreResult )
+		{
+			newStatus = TestStatus::eNegligible;
+		}
+
+		m_test.runDate = runDate;
+		m_test.times = times;
+		assert( m_test.runDate.IsValid() );
+		plugin.updateEngineRefDate();
+		m_test.engineDate = plugin.getEngineRefDate();
+		assert( m_test.engineDate.IsValid() );
+		m_test.testDate = m_database->getPlugin().getTestDate( m_test );
+		assert( m_test.testDate.IsValid() );
+		updateStatusNW( newStatus );
+	}
+
 	void DatabaseTest::updateOutOfDate( bool remove )const
 	{
 		bool outOfEngineDate{ m_database->getPlugin().isOutOfEngineDate( m_test ) };
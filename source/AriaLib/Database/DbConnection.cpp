@@ -385,7 +385,18 @@ namespace aria::db
 		FieldPtr getValue< FieldType::eDatetime >( sqlite3_stmt * statement, int i, Connection & connection, ValuedObjectInfos & infos )
 		{
 			FieldPtr field = std::make_unique< Field >( connection, infos );
-			static_cast< ValueT< FieldType::eDatetime > & >( field->getObjectValue() ).setValue( connection.parseDateTime( getFieldTextValue( statement, i, connection ) ) );
+			auto & value = static_cast< ValueT< FieldType::eDatetime > & >( field->getObjectValue() );
+
+			if ( sqlite3_column_type( statement, i ) == SQLITE_INTEGER )
+			{
+				value.setValue( DateTime{ time_t( sqlite3_column_int64( statement, i ) ) } );
+			}
+			else
+			{
+				// Dates written before the database V8 are formatted strings.
+				value.setValue( connection.parseDateTime( getFieldTextValue( statement, i, connection ) ) );
+			}
+
 			return field;
 		}
 
@@ -664,21 +675,37 @@ namespace aria::db
 
 	//*********************************************************************************************
 
-	Connection::Connection( wxFileName databaseFile )
+	Connection::Connection( wxFileName databaseFile
+		, ConnectionOptions const & options
+		, bool readOnly )
+		: m_readOnly{ readOnly }
 	{
 		wxString fileName = databaseFile.GetFullPath();
 
-		if ( !wxFileExists( fileName ) )
+		if ( m_readOnly )
 		{
-			if ( auto file = fopen( fileName.char_str( wxConvUTF8 ), "w" ) )
+			sqliteCheck( sqlite3_open_v2( fileName.char_str( wxConvUTF8 ), &m_database, SQLITE_OPEN_READONLY, nullptr )
+				, wxString() << conn::INFO_SQLITE_SELECTION
+				, m_database );
+			// Readers may still have to wait for a checkpoint or a journal mode change.
+			sqlite3_busy_timeout( m_database, 1000 );
+		}
+		else
+		{
+			if ( !wxFileExists( fileName ) )
 			{
-				fclose( file );
+				if ( auto file = fopen( fileName.char_str( wxConvUTF8 ), "w" ) )
+				{
+					fclose( file );
+				}
 			}
+
+			sqliteCheck( sqlite3_open( fileName.char_str( wxConvUTF8 ), &m_database )
+				, wxString() << conn::INFO_SQLITE_SELECTION
+				, m_database );
 		}
 
-		sqliteCheck( sqlite3_open( fileName.char_str( wxConvUTF8 ), &m_database )
-			, wxString() << conn::INFO_SQLITE_SELECTION
-			, m_database );
+		configure( options );
 	}
 
 	Connection::~Connection()
@@ -686,6 +713,57 @@ namespace aria::db
 		sqlite3_close( m_database );
 	}
 
+	void Connection::configure( ConnectionOptions const & options )
+	{
+		// These pragmas are bound to the connection, and must be set again each time the database is opened.
+		static char const * const synchronous[]{ "OFF", "NORMAL", "FULL" };
+		executeUpdate( std::string{ "PRAGMA synchronous=" } + synchronous[size_t( options.synchronous )] + ";" );
+		executeUpdate( "PRAGMA temp_store=" + std::to_string( int( options.tempStore ) ) + ";" );
+		executeUpdate( "PRAGMA cache_size=" + std::to_string( options.cacheSize ) + ";" );
+		executeUpdate( "PRAGMA mmap_size=" + std::to_string( options.mmapSize ) + ";" );
+	}
+
+	bool Connection::checkpoint()
+	{
+		// Unlike a PASSIVE one, a TRUNCATE checkpoint waits for the readers, instead of leaving frames in the WAL.
+		// The writer connection doesn't wait otherwise, so the busy timeout is only set for its duration.
+		sqlite3_busy_timeout( m_database, 1000 );
+		auto result = sqlite3_wal_checkpoint_v2( m_database, nullptr, SQLITE_CHECKPOINT_TRUNCATE, nullptr, nullptr );
+		sqlite3_busy_timeout( m_database, 0 );
+		return result == SQLITE_OK;
+	}
+
+	bool Connection::isInTransaction()const
+	{
+		return sqlite3_get_autocommit( m_database ) == 0;
+	}
+
+	bool Connection::setJournalMode( JournalMode mode )
+	{
+		// The journal mode is stored in the database file, the query returns the mode actually in use.
+		std::string name = mode == JournalMode::eWal ? "wal" : "delete";
+		bool result = false;
+
+		try
+		{
+			sqlite3_stmt * statement = conn::sqlitePrepareStatement( "PRAGMA journal_mode=" + name + ";", m_database );
+
+			if ( sqlite3_step( statement ) == SQLITE_ROW )
+			{
+				auto text = reinterpret_cast< char const * >( sqlite3_column_text( statement, 0 ) );
+				result = text && name == text;
+			}
+
+			sqliteCheck( sqlite3_finalize( statement ), conn::INFO_SQLITE_STATEMENT_FINALISATION, m_database );
+		}
+		catch ( std::exception & exc )
+		{
+			wxLogError( exc.what() );
+		}
+
+		return result;
+	}
+
 	bool Connection::executeUpdate( sqlite3_stmt * statement )
 	{
 		ValuedObjectInfosArray infos;
@@ -798,7 +876,7 @@ namespace aria::db
 
 		if ( dateTime.IsValid() )
 		{
-			strReturn = dateTime.FormatISODate() + " " + dateTime.FormatISOTime();
+			strReturn = std::to_string( int64_t( dateTime.GetTicks() ) );
 		}
 		else
 		{
@@ -0,0 +1,154 @@
+#include "Database/DbCursor.hpp"
+
+#include "Database/DbConnection.hpp"
+
+namespace aria::db
+{
+	//*********************************************************************************************
+
+	namespace cursor
+	{
+		static const char * ERROR_SQLITE_STATEMENT_STEP = "Statement step failed: ";
+
+		static int parseInt( char const *& it
+			, char const * end
+			, int count )
+		{
+			int result{};
+
+			while ( count-- && it != end )
+			{
+				result = result * 10 + ( *it - '0' );
+				++it;
+			}
+
+			return result;
+		}
+	}
+
+	//*********************************************************************************************
+
+	Cursor::Cursor( Connection & connection
+		, sqlite3_stmt * statement )
+		: m_connection{ &connection }
+		, m_statement{ statement }
+	{
+	}
+
+	Cursor::Cursor( Cursor && rhs )noexcept
+		: m_connection{ rhs.m_connection }
+		, m_statement{ rhs.m_statement }
+		, m_valid{ rhs.m_valid }
+	{
+		rhs.m_statement = nullptr;
+	}
+
+	Cursor::~Cursor()
+	{
+		if ( m_statement )
+		{
+			sqlite3_clear_bindings( m_statement );
+			sqlite3_reset( m_statement );
+		}
+	}
+
+	bool Cursor::next()
+	{
+		if ( !m_valid )
+		{
+			return false;
+		}
+
+		auto ret = sqlite3_step( m_statement );
+
+		if ( ret == SQLITE_ROW )
+		{
+			return true;
+		}
+
+		if ( ret != SQLITE_DONE )
+		{
+			m_valid = false;
+			wxLogError( wxString() << cursor::ERROR_SQLITE_STATEMENT_STEP << sqlite3_errmsg( m_connection->getConnection() ) );
+		}
+
+		return false;
+	}
+
+	bool Cursor::isNull( int index )const
+	{
+		return sqlite3_column_type( m_statement, index ) == SQLITE_NULL;
+	}
+
+	int32_t Cursor::getInt32( int index )const
+	{
+		return sqlite3_column_int( m_statement, index );
+	}
+
+	int64_t Cursor::getInt64( int index )const
+	{
+		return sqlite3_column_int64( m_statement, index );
+	}
+
+	double Cursor::getDouble( int index )const
+	{
+		return sqlite3_column_double( m_statement, index );
+	}
+
+	std::string_view Cursor::getText( int index )const
+	{
+		auto text = reinterpret_cast< char const * >( sqlite3_column_text( m_statement, index ) );
+
+		if ( !text )
+		{
+			return std::string_view{};
+		}
+
+		return std::string_view{ text, size_t( sqlite3_column_bytes( m_statement, index ) ) };
+	}
+
+	DateTime Cursor::getDateTime( int index )const
+	{
+		switch ( sqlite3_column_type( m_statement, index ) )
+		{
+		case SQLITE_INTEGER:
+			return DateTime{ time_t( sqlite3_column_int64( m_statement, index ) ) };
+		case SQLITE_NULL:
+			return DateTime{};
+		default:
+			break;
+		}
+
+		// Dates written before the database V8 are formatted as YYYY-mm-dd HH:MM:SS.
+		auto text = getText( index );
+
+		if ( text.size() < SQLITE_STMT_DATETIME_SIZE )
+		{
+			return DateTime{};
+		}
+
+		auto it = text.data();
+		auto end = it + text.size();
+		auto year = cursor::parseInt( it, end, 4 );
+		auto month = cursor::parseInt( ++it, end, 2 );
+		auto day = cursor::parseInt( ++it, end, 2 );
+		auto hour = cursor::parseInt( ++it, end, 2 );
+		auto minute = cursor::parseInt( ++it, end, 2 );
+		auto second = cursor::parseInt( ++it, end, 2 );
+
+		if ( month < 1 || month > 12
+			|| day < 1 || day > 31 )
+		{
+			return DateTime{};
+		}
+
+		return DateTime{ wxDateTime::wxDateTime_t( day )
+			, wxDateTime::Month( month - 1 )
+			, year
+			, wxDateTime::wxDateTime_t( hour )
+			, wxDateTime::wxDateTime_t( minute )
+			, wxDateTime::wxDateTime_t( second ) };
+	}
+
+	//*********************************************************************************************
+}
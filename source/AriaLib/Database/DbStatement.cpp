@@ -133,6 +133,19 @@ namespace aria::db
 		return result;
 	}
 
+	Cursor Statement::executeCursor()
+	{
+		if ( !m_initialised )
+		{
+			throw std::runtime_error{ stmt::ERROR_DB_STATEMENT_NOT_INITIALISED };
+		}
+
+		// Output parameters are retrieved after the whole result is fetched, which a cursor doesn't do.
+		assert( m_outParams.empty() );
+		doPreExecute();
+		return Cursor{ m_connection, m_statement };
+	}
+
 	Parameter * Statement::createParameter( const std::string & name
 		, FieldType fieldType
 		, ParameterType parameterType )
@@ -1,17 +1,24 @@
 ﻿#include "Database/TestDatabase.hpp"
 
 #include "Plugin.hpp"
+#include "TestsCounts.hpp"
 #include "Database/DatabaseTest.hpp"
 #include "Database/DbResult.hpp"
 #include "Database/DbStatement.hpp"
+#include "Progress.hpp"
 #include "FileSystem/FileSystem.hpp"
 
 #include "AriaLib/BeginExternHeaderGuard.hpp"
 #include <wx/dir.h>
-#include <wx/choicdlg.h>
-#include <wx/progdlg.h>
+#include <wx/filefn.h>
 
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
 #include <set>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
 #include "AriaLib/EndExternHeaderGuard.hpp"
 
@@ -234,6 +241,7 @@ namespace aria
 
 			void cleanup()
 			{
+				folderNodes.clear();
 				removeEmpty();
 				auto it = nodes.begin();
 
@@ -306,11 +314,19 @@ namespace aria
 			void addFile( wxFileName const & fdr
 				, wxString const & name )
 			{
-				auto node = addFolder( fdr.GetFullPath() );
-				node->files.push_back( ( fdr / name ).GetFullPath() );
+				auto path = fdr.GetFullPath();
+				auto it = folderNodes.find( path );
+
+				if ( it == folderNodes.end() )
+				{
+					it = folderNodes.emplace( path, addFolder( path ) ).first;
+				}
+
+				it->second->files.push_back( ( fdr / name ).GetFullPath() );
 			}
 
 			NodeCont nodes;
+			NodeMap folderNodes;
 			wxFileName folder;
 		};
 
@@ -336,154 +352,385 @@ namespace aria
 			return result;
 		}
 
-		static TestArray::iterator findTest( TestArray & result
-			, std::string const & name )
+		struct ScannedRun
 		{
-			return std::find_if( result.begin()
-				, result.end()
-				, [&name]( TestPtr const & lookup )
-				{
-					return lookup->name == name;
-				} );
-		}
+			std::string test;
+			std::string renderer;
+			db::DateTime runDate;
+			TestStatus status;
+		};
 
-		static void makeTestRun( Config const & config
-			, TestDatabase::InsertRenderer & insertRenderer
-			, TestDatabase::InsertTest & insertTest
-			, TestDatabase::InsertRunV2 & insertRun
-			, IdValue * category
-			, TestArray & categoryTests
-			, wxFileName const & imgPath
-			, TestStatus status
-			, RendererMap & renderers )
+		struct ScannedFolder
 		{
-			auto name = makeStdString( imgPath.GetName() + "." + imgPath.GetExt() );
-			auto prevDotIdx = name.find_last_of( "." );
+			std::string path;
+			db::DateTime modificationTime;
+			// true when the folder was imported before, its runs may already be in the database.
+			bool imported{};
+			std::vector< ScannedRun > runs;
+		};
 
-			if ( prevDotIdx == std::string::npos
-				|| name.substr( prevDotIdx + 1 ) != "diff" )
+		struct ScannedCategory
+		{
+			wxString name;
+			wxFileName path;
+			Node const * node{};
+			std::vector< ScannedFolder > folders;
+		};
+
+		using ImportedFolderMap = std::unordered_map< std::string, db::DateTime >;
+
+		struct UpdateImportedFolder
+		{
+			explicit UpdateImportedFolder( db::Connection & connection )
+				: stmt{ connection.createStatement( "INSERT OR REPLACE INTO ImportedFolder (Path, ModificationTime) VALUES (?, ?);" ) }
+				, path{ stmt->createParameter( "Path", db::FieldType::eVarchar, 1024 ) }
+				, modificationTime{ stmt->createParameter( "ModificationTime", db::FieldType::eDatetime ) }
+			{
+				if ( !stmt->initialise() )
+				{
+					throw std::runtime_error{ "Couldn't create UpdateImportedFolder INSERT statement." };
+				}
+			}
+
+			void update( std::string const & inPath
+				, db::DateTime const & inModificationTime )
 			{
-				auto rendererIdx = name.find_last_of( "_" );
+				path->setValue( inPath );
+				modificationTime->setValue( inModificationTime );
 
-				if ( rendererIdx != std::string::npos )
+				if ( !stmt->executeUpdate() )
 				{
-					auto renderer = getRenderer( name.substr( rendererIdx + 1 )
-						, renderers
-						, insertRenderer );
-					name = name.substr( 0, rendererIdx );
-					auto runDate = getFileDate( imgPath );
+					throw std::runtime_error{ "Couldn't update imported folder" };
+				}
+			}
 
-					if ( runDate.IsValid() )
-					{
-						auto it = findTest( categoryTests, name );
+		private:
+			db::StatementPtr stmt;
+			db::Parameter * path{};
+			db::Parameter * modificationTime{};
+		};
 
-						if ( it == categoryTests.end() )
-						{
-							it = categoryTests.emplace( it
-								, std::make_unique< Test >( 0
-									, name
-									, category ) );
-							( *it )->id = insertTest.insert( category->id, name );
-						}
+		struct CheckRunExists
+		{
+			explicit CheckRunExists( db::Connection & connection )
+				: stmt{ connection.createStatement( "SELECT Id FROM TestRun WHERE TestId=? AND RendererId=? AND RunDate=? AND Status=?;" ) }
+				, testId{ stmt->createParameter( "TestId", db::FieldType::eSint32 ) }
+				, rendererId{ stmt->createParameter( "RendererId", db::FieldType::eSint32 ) }
+				, runDate{ stmt->createParameter( "RunDate", db::FieldType::eDatetime ) }
+				, status{ stmt->createParameter( "Status", db::FieldType::eSint32 ) }
+			{
+				if ( !stmt->initialise() )
+				{
+					throw std::runtime_error{ "Couldn't create CheckRunExists SELECT statement." };
+				}
+			}
 
-						Test & test = *( *it );
-						insertRun.insert( test.id
-							, renderer->id
-							, runDate
-							, status
-							, runDate
-							, runDate );
-					}
+			bool check( int32_t inTestId
+				, int32_t inRendererId
+				, db::DateTime const & inRunDate
+				, TestStatus inStatus )
+			{
+				testId->setValue( inTestId );
+				rendererId->setValue( inRendererId );
+				runDate->setValue( inRunDate );
+				status->setValue( int32_t( inStatus ) );
+				auto result = stmt->executeSelect();
+				return result && !result->empty();
+			}
+
+		private:
+			db::StatementPtr stmt;
+			db::Parameter * testId{};
+			db::Parameter * rendererId{};
+			db::Parameter * runDate{};
+			db::Parameter * status{};
+		};
+
+		static ImportedFolderMap listImportedFolders( db::Connection & connection )
+		{
+			ImportedFolderMap result;
+
+			if ( auto res = connection.executeSelect( "SELECT Path, ModificationTime FROM ImportedFolder;" ) )
+			{
+				for ( auto & row : *res )
+				{
+					result.emplace( row.getField( 0 ).getValue< std::string >()
+						, row.getField( 1 ).getValue< db::DateTime >() );
 				}
 			}
+
+			return result;
 		}
 
-		static void listAllResults( Config const & config
-			, TestDatabase::InsertRenderer & insertRenderer
-			, TestDatabase::InsertTest & insertTest
-			, TestDatabase::InsertRunV2 & insertRun
-			, wxFileName const & categoryPath
-			, PathArray const & folders
-			, Category category
-			, TestArray & categoryTests
-			, RendererMap & renderers )
+		static db::DateTime getModificationTime( wxString const & path )
 		{
-			for ( auto & status : folders )
+			auto time = wxFileModificationTime( path );
+
+			if ( time == time_t( -1 ) )
 			{
-				auto testStatus = getStatus( makeStdString( status.GetFullPath() ) );
-				filterDirectoryFiles( status
-					, [&config, &insertRenderer, &insertTest, &insertRun, &renderers, &categoryTests, category, testStatus]( wxString const & folder, wxString const & name )
+				return db::DateTime{};
+			}
+
+			return db::DateTime{ time };
+		}
+
+		// Runs on a worker thread: lists the result images of the category status folders,
+		// skipping the folders that didn't change since their last import.
+		static void scanCategory( ScannedCategory & category
+			, ImportedFolderMap const & importedFolders )
+		{
+			auto compareFolder = category.path / wxT( "Compare" );
+			PathArray folders
+			{
+				compareFolder / "Negligible",
+				compareFolder / "Acceptable",
+				compareFolder / "Unacceptable",
+				compareFolder / "Unprocessed",
+			};
+
+			for ( auto & folder : folders )
+			{
+				auto folderPath = folder.GetFullPath();
+				wxDir dir{ folderPath };
+
+				if ( !dir.IsOpened() )
+				{
+					continue;
+				}
+
+				ScannedFolder scanned{ makeStdString( folderPath )
+					, getModificationTime( folderPath ) };
+				auto it = importedFolders.find( scanned.path );
+
+				if ( it != importedFolders.end() )
+				{
+					if ( scanned.modificationTime.IsValid()
+						&& it->second.IsValid()
+						&& it->second == scanned.modificationTime )
+					{
+						continue;
+					}
+
+					scanned.imported = true;
+				}
+
+				auto status = getStatus( makeStdString( folder.GetFullName() ) );
+				auto prefix = folderPath + wxFileName::GetPathSeparator();
+				wxString fileName;
+				bool cont = dir.GetFirst( &fileName, wxT( "*.png" ), wxDIR_FILES );
+
+				while ( cont )
+				{
+					// <test>_<renderer>.png, and <test>_<renderer>.diff.png for the diff images.
+					auto name = makeStdString( fileName.substr( 0u, fileName.size() - 4u ) );
+					auto prevDotIdx = name.find_last_of( "." );
+
+					if ( prevDotIdx == std::string::npos
+						|| name.substr( prevDotIdx + 1 ) != "diff" )
 					{
-						auto result = getExtension( name ) == wxT( "png" );
+						auto rendererIdx = name.find_last_of( "_" );
 
-						if ( result )
+						if ( rendererIdx != std::string::npos )
 						{
-							makeTestRun( config
-								, insertRenderer
-								, insertTest
-								, insertRun
-								, category
-								, categoryTests
-								, folder / name
-								, testStatus
-								, renderers );
+							auto runDate = getModificationTime( prefix + fileName );
+
+							if ( runDate.IsValid() )
+							{
+								scanned.runs.push_back( { name.substr( 0, rendererIdx )
+									, name.substr( rendererIdx + 1 )
+									, runDate
+									, status } );
+							}
 						}
+					}
 
-						return result;
-					} );
+					cont = dir.GetNext( &fileName );
+				}
+
+				category.folders.push_back( std::move( scanned ) );
 			}
 		}
 
-		static TestArray listCategoryTestFiles( Plugin const & plugin
-			, Config const & config
+		// Runs on the calling thread, the only one writing to the database.
+		static TestArray writeCategory( Plugin const & plugin
+			, db::Connection & connection
 			, TestDatabase::InsertRenderer & insertRenderer
 			, TestDatabase::InsertTest & insertTest
 			, TestDatabase::InsertRunV2 & insertRun
-			, wxFileName const & categoryPath
+			, CheckRunExists & checkRun
+			, UpdateImportedFolder & updateFolder
+			, ScannedCategory const & scanned
 			, Category category
-			, Node const & node
 			, RendererMap & renderers )
 		{
 			getRenderer( "vk", renderers, insertRenderer );
-			auto compareFolder = categoryPath / wxT( "Compare" );
-			PathArray folders
+			TestArray result;
+			std::unordered_map< std::string, Test * > tests;
+
+			if ( auto res = connection.executeSelect( "SELECT Id, Name FROM Test WHERE CategoryId=" + std::to_string( category->id ) + ";" ) )
 			{
-				compareFolder / "Negligible",
-				compareFolder / "Acceptable",
-				compareFolder / "Unacceptable",
-				compareFolder / "Unprocessed",
+				for ( auto & row : *res )
+				{
+					auto name = row.getField( 1 ).getValue< std::string >();
+					result.push_back( std::make_unique< Test >( row.getField( 0 ).getValue< int32_t >()
+						, name
+						, category ) );
+					tests.emplace( name, result.back().get() );
+				}
+			}
+
+			auto getTest = [&]( std::string const & name
+				, bool & created )
+			{
+				auto ires = tests.emplace( name, nullptr );
+				created = ires.second;
+
+				if ( created )
+				{
+					result.push_back( std::make_unique< Test >( 0
+						, name
+						, category ) );
+					result.back()->id = insertTest.insert( category->id, name );
+					ires.first->second = result.back().get();
+				}
+
+				return ires.first->second;
 			};
-			TestArray result;
 
-			for ( auto & testScene : node.files )
+			for ( auto & testScene : scanned.node->files )
 			{
-				auto sceneName = makeStdString( wxFileName{ testScene }.GetName() );
-				auto it = findTest( result, sceneName );
+				bool created{};
+				auto test = getTest( makeStdString( wxFileName{ testScene }.GetName() ), created );
 
-				if ( it == result.end() )
+				if ( created )
 				{
-					auto test = std::make_unique< Test >( 0
-						, sceneName
-						, category );
-					test->id = insertTest.insert( test->category->id, test->name );
 					auto name = plugin.getTestFileName( *test );
 					wxRenameFile( testScene, name.GetFullPath() );
-					result.push_back( std::move( test ) );
 				}
 			}
 
-			listAllResults( config
-				, insertRenderer
-				, insertTest
-				, insertRun
-				, categoryPath
-				, folders
-				, category
-				, result
-				, renderers );
+			for ( auto & folder : scanned.folders )
+			{
+				for ( auto & run : folder.runs )
+				{
+					auto renderer = getRenderer( run.renderer, renderers, insertRenderer );
+					bool created{};
+					auto test = getTest( run.test, created );
+
+					if ( created
+						|| !folder.imported
+						|| !checkRun.check( test->id, renderer->id, run.runDate, run.status ) )
+					{
+						insertRun.insert( test->id
+							, renderer->id
+							, run.runDate
+							, run.status
+							, run.runDate
+							, run.runDate );
+					}
+				}
+
+				if ( folder.modificationTime.IsValid() )
+				{
+					updateFolder.update( folder.path, folder.modificationTime );
+				}
+			}
 
 			return result;
 		}
+
+		// Reads a row from the latest runs queries, starting at the TestId column.
+		static void updateLatestRun( db::Cursor const & cursor
+			, HostMap const & hosts
+			, DatabaseTest & dbTest )
+		{
+			auto runId = cursor.getInt32( 2 );
+			auto runDate = cursor.getDateTime( 3 );
+			auto hostId = cursor.getInt32( 4 );
+			auto status = TestStatus( cursor.getInt32( 5 ) );
+			auto engineData = cursor.getDateTime( 6 );
+			auto testDate = cursor.getDateTime( 7 );
+			auto totalTime = Microseconds{ uint64_t( cursor.getInt32( 8 ) ) };
+			auto avgFrameTime = Microseconds{ uint64_t( cursor.getInt32( 9 ) ) };
+			auto lastFrameTime = Microseconds{ uint64_t( cursor.getInt32( 10 ) ) };
+			auto hostIt = hosts.find( hostId );
+			assert( hostIt != hosts.end() );
+			assert( dbTest.getStatus() == TestStatus::eNotRun );
+			dbTest.update( runId
+				, runDate
+				, status
+				, engineData
+				, testDate
+				, TestTimes{ hostIt->second.get(), totalTime, avgFrameTime, lastFrameTime } );
+		}
+
+		// Used by the listings called without progress, the proposed selections are kept.
+		class NoProgress
+			: public Progress
+		{
+		public:
+			void setTitle( wxString const & title )override
+			{
+			}
+
+			int getRange()const override
+			{
+				return m_range;
+			}
+
+			void setRange( int range )override
+			{
+				m_range = range;
+			}
+
+			void update( int index )override
+			{
+			}
+
+			void update( int index
+				, wxString const & message )override
+			{
+			}
+
+			void fit()override
+			{
+			}
+
+			bool select( wxString const & title
+				, wxString const & message
+				, wxArrayString const & choices
+				, wxArrayInt & selections )override
+			{
+				return true;
+			}
+
+		private:
+			int m_range{ 1 };
+		};
+
+		// Repainting the progress costs more than reading a row, so it is updated at most every 50 ms.
+		template< typename MessageFuncT >
+		static void stepProgress( Progress & progress
+			, int & index
+			, MessageFuncT getMessage )
+		{
+			static thread_local std::chrono::steady_clock::time_point lastUpdate{};
+			auto now = std::chrono::steady_clock::now();
+			++index;
+
+			if ( now - lastUpdate < std::chrono::milliseconds{ 50 } )
+			{
+				return;
+			}
+
+			lastUpdate = now;
+#if defined( _WIN32 )
+			progress.update( index, getMessage() );
+			progress.fit();
+#else
+			progress.update( index );
+#endif
+		}
 	}
 
 	//*********************************************************************************************
@@ -586,31 +833,18 @@ namespace aria
 		, db::DateTime const & dateScene )
 	{
 		testId->setValue( id );
-		sTestId->setValue( id );
 		rendererId->setValue( inRendererId );
-		sRendererId->setValue( inRendererId );
 		runDate->setValue( dateRun );
-		sRunDate->setValue( dateRun );
 		status->setValue( int32_t( inStatus ) );
-		sStatus->setValue( int32_t( inStatus ) );
 		engineDate->setValue( dateEngine );
-		sEngineDate->setValue( dateEngine );
 		testDate->setValue( dateScene );
-		sTestDate->setValue( dateScene );
 
 		if ( !stmt->executeUpdate() )
 		{
 			return -1;
 		}
 
-		auto result = select->executeSelect();
-
-		if ( !result || result->empty() )
-		{
-			return -1;
-		}
-
-		return result->begin()->getField( 0 ).getValue< int32_t >();
+		return int32_t( connection->getLastInsertId() );
 	}
 
 	//*********************************************************************************************
@@ -627,39 +861,22 @@ namespace aria
 		, Host const & host )
 	{
 		testId->setValue( id );
-		sTestId->setValue( id );
 		rendererId->setValue( inRendererId );
-		sRendererId->setValue( inRendererId );
 		runDate->setValue( dateRun );
-		sRunDate->setValue( dateRun );
 		status->setValue( int32_t( inStatus ) );
-		sStatus->setValue( int32_t( inStatus ) );
 		engineDate->setValue( dateEngine );
-		sEngineDate->setValue( dateEngine );
 		testDate->setValue( dateScene );
-		sTestDate->setValue( dateScene );
 		totalTime->setValue( uint32_t( timeTotal.count() ) );
-		sTotalTime->setValue( uint32_t( timeTotal.count() ) );
 		avgFrameTime->setValue( uint32_t( timeAvgFrame.count() ) );
-		sAvgFrameTime->setValue( uint32_t( timeAvgFrame.count() ) );
 		lastFrameTime->setValue( uint32_t( timeLastFrame.count() ) );
-		sLastFrameTime->setValue( uint32_t( timeLastFrame.count() ) );
 		hostId->setValue( host.id );
-		sHostId->setValue( host.id );
 
 		if ( !stmt->executeUpdate() )
 		{
 			return -1;
 		}
 
-		auto result = select->executeSelect();
-
-		if ( !result || result->empty() )
-		{
-			return -1;
-		}
-
-		return result->begin()->getField( 0 ).getValue< int32_t >();
+		return int32_t( connection->getLastInsertId() );
 	}
 
 	//*********************************************************************************************
@@ -763,7 +980,7 @@ namespace aria
 	//*********************************************************************************************
 
 	TestMap TestDatabase::ListTests::listTests( CategoryMap & categories
-		, wxProgressDialog & progress
+		, Progress & progress
 		, int & index )
 	{
 		TestMap result;
@@ -773,7 +990,7 @@ namespace aria
 
 	void TestDatabase::ListTests::listTests( CategoryMap & categories
 		, TestMap & result
-		, wxProgressDialog & progress
+		, Progress & progress
 		, int & index )
 	{
 		for ( auto & category : categories )
@@ -783,7 +1000,7 @@ namespace aria
 
 		if ( auto res = stmt->executeSelect() )
 		{
-			progress.SetRange( int( progress.GetRange() + res->size() ) );
+			progress.setRange( int( progress.getRange() + res->size() ) );
 
 			for ( auto & row : *res )
 			{
@@ -794,14 +1011,13 @@ namespace aria
 				auto category = testdb::getCategory( catId, categories );
 				auto catIt = result.emplace( category, TestArray{} ).first;
 				catIt->second.emplace_back( std::make_unique< Test >( id, name, category, ignoreResult != 0 ) );
-#if defined( _WIN32 )
-				progress.Update( index++
-					, _( "Listing tests" )
-					+ wxT( "\n" ) + getDetails( *catIt->second.back() ) );
-				progress.Fit();
-#else
-				progress.Update( index++ );
-#endif
+				testdb::stepProgress( progress
+					, index
+					, [&catIt]()
+					{
+						return _( "Listing tests" )
+							+ wxT( "\n" ) + getDetails( *catIt->second.back() );
+					} );
 			}
 		}
 		else
@@ -810,6 +1026,32 @@ namespace aria
 		}
 	}
 
+	void TestDatabase::ListTests::listTests( CategoryMap & categories
+		, TestMap & result )
+	{
+		for ( auto & category : categories )
+		{
+			result.emplace( category.second.get(), TestArray{} );
+		}
+
+		auto cursor = stmt->executeCursor();
+
+		while ( cursor.next() )
+		{
+			auto category = testdb::getCategory( cursor.getInt32( 1 ), categories );
+			auto catIt = result.emplace( category, TestArray{} ).first;
+			catIt->second.emplace_back( std::make_unique< Test >( cursor.getInt32( 0 )
+				, std::string{ cursor.getText( 2 ) }
+				, category
+				, cursor.getInt32( 3 ) != 0 ) );
+		}
+
+		if ( !cursor )
+		{
+			throw std::runtime_error{ "Couldn't list tests" };
+		}
+	}
+
 	//*********************************************************************************************
 
 	db::ResultPtr TestDatabase::ListLatestTestRun::listTests( int32_t inId )
@@ -824,7 +1066,7 @@ namespace aria
 		, HostMap & hosts
 		, CategoryMap & categories
 		, Renderer renderer
-		, wxProgressDialog & progress
+		, Progress & progress
 		, int & index )
 	{
 		RendererTestRuns result{ *database };
@@ -837,111 +1079,189 @@ namespace aria
 		, CategoryMap & categories
 		, Renderer renderer
 		, RendererTestRuns & result
-		, wxProgressDialog & progress
+		, Progress & progress
 		, int & index )
 	{
-		// Prefill result with "not run" entries.
+		// Prefill result with "not run" entries, and index them by test ID.
+		size_t count{ result.size() };
+
+		for ( auto & cat : tests )
+		{
+			count += cat.second.size();
+		}
+
+		std::unordered_map< int32_t, DatabaseTest * > slots;
+		slots.reserve( count );
+
+		for ( auto & run : result )
+		{
+			slots.emplace( run.getTestId(), &run );
+		}
+
 		for ( auto & cat : tests )
 		{
 			for ( auto & test : cat.second )
 			{
-				result.addTest( TestRun{ test.get()
-					, renderer
-					, db::DateTime{}
-					, TestStatus::eNotRun
-					, db::DateTime{}
-					, db::DateTime{}
-					, TestTimes{} } );
+				slots.emplace( test->id
+					, &result.addTest( TestRun{ test.get()
+						, renderer
+						, db::DateTime{}
+						, TestStatus::eNotRun
+						, db::DateTime{}
+						, db::DateTime{}
+						, TestTimes{} } ) );
 			}
 		}
 
 		rendererId->setValue( renderer->id );
+		// There is at most one latest run per test, the range is adjusted once the rows are read.
+		progress.setRange( int( progress.getRange() + slots.size() ) );
+		auto cursor = stmt->executeCursor();
+		size_t rows{};
 
-		if ( auto res = stmt->executeSelect() )
+		while ( cursor.next() )
 		{
-			progress.SetRange( int( progress.GetRange() + res->size() ) );
+			auto slotIt = slots.find( cursor.getInt32( 1 ) );
 
-			for ( auto & row : *res )
+			if ( slotIt != slots.end() )
 			{
-				auto catId = row.getField( 0 ).getValue< int32_t >();
-				auto catIt = tests.find( testdb::getCategory( catId, categories ) );
+				auto & dbTest = *slotIt->second;
+				testdb::updateLatestRun( cursor, hosts, dbTest );
+				++rows;
+				testdb::stepProgress( progress
+					, index
+					, [&dbTest]()
+					{
+						return _( "Listing latest runs" )
+							+ wxT( "\n" ) + getProgressDetails( dbTest );
+					} );
+			}
+		}
 
-				if ( catIt != tests.end() )
-				{
-					auto testId = row.getField( 1 ).getValue< int32_t >();
-					auto testIt = std::find_if( catIt->second.begin()
-						, catIt->second.end()
-						, [testId]( TestPtr const & lookup )
-						{
-							return lookup->id == testId;
-						} );
+		progress.setRange( int( progress.getRange() - ( slots.size() - rows ) ) );
 
-					if ( testIt != catIt->second.end() )
-					{
-						auto & test = *testIt->get();
-						auto runId = row.getField( 2 ).getValue< int32_t >();
-						auto runDate = row.getField( 3 ).getValue< db::DateTime >();
-						auto hostId = row.getField( 4 ).getValue< int32_t >();
-						auto status = TestStatus( row.getField( 5 ).getValue< int32_t >() );
-						auto engineData = row.getField( 6 ).getValue< db::DateTime >();
-						auto testDate = row.getField( 7 ).getValue< db::DateTime >();
-						auto totalTime = Microseconds{ uint64_t( row.getField( 8 ).getValue< int32_t >() ) };
-						auto avgFrameTime = Microseconds{ uint64_t( row.getField( 9 ).getValue< int32_t >() ) };
-						auto lastFrameTime = Microseconds{ uint64_t( row.getField( 10 ).getValue< int32_t >() ) };
-						auto it = std::find_if( result.begin()
-							, result.end()
-							, [testId]( DatabaseTest const & lookup )
-							{
-								return lookup->test->id == testId;
-							} );
-						auto hostIt = hosts.find( hostId );
-						assert( hostIt != hosts.end() );
+		if ( !cursor )
+		{
+			throw std::runtime_error{ "Couldn't list tests runs" };
+		}
+	}
 
-						if ( it == result.end() )
-						{
-							assert( false );
-							auto & dbTest = result.addTest( TestRun{ &test
-								, renderer
-								, runDate
-								, status
-								, engineData
-								, testDate
-								, TestTimes{ hostIt->second.get(), totalTime, avgFrameTime, lastFrameTime } } );
-							dbTest.update( runId );
-#if defined( _WIN32 )
-							progress.Update( index++
-								, _( "Listing latest runs" )
-								+ wxT( "\n" ) + getProgressDetails( dbTest ) );
-							progress.Fit();
-#else
-							progress.Update( index++ );
-#endif
-						}
-						else
-						{
-							assert( it->getStatus() == TestStatus::eNotRun );
-							it->update( runId
-								, runDate
-								, status
-								, engineData
-								, testDate
-								, TestTimes{ hostIt->second.get(), totalTime, avgFrameTime, lastFrameTime } );
-#if defined( _WIN32 )
-							progress.Update( index++
-								, _( "Listing latest runs" )
-								+ wxT( "\n" ) + getProgressDetails( *it ) );
-							progress.Fit();
-#else
-							progress.Update( index++ );
-#endif
-						}
-					}
-				}
+	//*********************************************************************************************
+
+	DatabaseTestArray TestDatabase::ListLatestCategoryTests::listTests( TestArray const & tests
+		, HostMap const & hosts
+		, Renderer renderer
+		, Category category
+		, RendererTestRuns & result )
+	{
+		DatabaseTestArray ret;
+		ret.reserve( tests.size() );
+		std::unordered_map< int32_t, DatabaseTest * > slots;
+		slots.reserve( tests.size() );
+
+		for ( auto & test : tests )
+		{
+			auto & dbTest = result.addTest( TestRun{ test.get()
+				, renderer
+				, db::DateTime{}
+				, TestStatus::eNotRun
+				, db::DateTime{}
+				, db::DateTime{}
+				, TestTimes{} } );
+			slots.emplace( test->id, &dbTest );
+			ret.push_back( &dbTest );
+		}
+
+		rendererId->setValue( renderer->id );
+		categoryId->setValue( category->id );
+		auto cursor = stmt->executeCursor();
+
+		while ( cursor.next() )
+		{
+			auto slotIt = slots.find( cursor.getInt32( 1 ) );
+
+			if ( slotIt != slots.end() )
+			{
+				testdb::updateLatestRun( cursor, hosts, *slotIt->second );
 			}
 		}
-		else
+
+		if ( !cursor )
 		{
-			throw std::runtime_error{ "Couldn't list tests runs" };
+			throw std::runtime_error{ "Couldn't list category tests runs" };
+		}
+
+		return ret;
+	}
+
+	//*********************************************************************************************
+
+	void TestDatabase::CountLatestRendererTests::countTests( TestMap const & tests
+		, Renderer renderer
+		, db::DateTime const & refDate
+		, RendererTestsCounts & result )
+	{
+		std::unordered_map< int32_t, std::pair< TestsCounts *, uint32_t > > categories;
+
+		for ( auto & cat : tests )
+		{
+			auto countsIt = result.getCategories().find( cat.first );
+
+			if ( countsIt != result.getCategories().end() )
+			{
+				categories.emplace( cat.first->id, std::make_pair( &countsIt->second, 0u ) );
+			}
+		}
+
+		engineRefDate->setValue( refDate );
+		rendererId->setValue( renderer->id );
+		auto cursor = stmt->executeCursor();
+
+		while ( cursor.next() )
+		{
+			auto catIt = categories.find( cursor.getInt32( 0 ) );
+
+			if ( catIt != categories.end() )
+			{
+				auto count = uint32_t( cursor.getInt32( 2 ) );
+				catIt->second.first->add( TestStatus( cursor.getInt32( 1 ) ), count );
+				// Only the engine date is known here, the scene dates come with the category tests.
+				catIt->second.first->addOutdated( uint32_t( cursor.getInt32( 3 ) ) );
+				catIt->second.second += count;
+			}
+		}
+
+		if ( !cursor )
+		{
+			throw std::runtime_error{ "Couldn't count tests runs" };
+		}
+
+		// The tests without run in this renderer, and the ignored ones, are known without querying the runs.
+		for ( auto & cat : tests )
+		{
+			auto catIt = categories.find( cat.first->id );
+
+			if ( catIt == categories.end() )
+			{
+				continue;
+			}
+
+			auto & counts = *catIt->second.first;
+			auto withRun = catIt->second.second;
+			auto all = uint32_t( cat.second.size() );
+
+			if ( all > withRun )
+			{
+				counts.add( TestStatus::eNotRun, all - withRun );
+			}
+
+			for ( auto & test : cat.second )
+			{
+				if ( test->ignoreResult )
+				{
+					counts.addIgnored();
+				}
+			}
 		}
 	}
 
@@ -953,23 +1273,22 @@ namespace aria
 		RunMap result;
 		id->setValue( testId );
 
-		if ( auto res = stmt->executeSelect() )
+		auto cursor = stmt->executeCursor();
+
+		while ( cursor.next() )
 		{
-			for ( auto & row : *res )
-			{
-				Run run;
-				run.id = uint32_t( row.getField( 0 ).getValue< int32_t >() );
-				run.status = RunStatus( row.getField( 1 ).getValue< int32_t >() );
-				run.runDate = row.getField( 2 ).getValue< db::DateTime >();
-				auto hostId = row.getField( 3 ).getValue< int32_t >();
-				auto hostIt = hosts.find( hostId );
-				assert( hostIt != hosts.end() );
-				run.host = hostIt->second.get();
-				run.totalTime = Microseconds{ uint64_t( row.getField( 4 ).getValue< int32_t >() ) };
-				run.avgTime = Microseconds{ uint64_t( row.getField( 5 ).getValue< int32_t >() ) };
-				run.lastTime = Microseconds{ uint64_t( row.getField( 6 ).getValue< int32_t >() ) };
-				result.insert( { run.runDate, run } );
-			}
+			Run run;
+			run.id = uint32_t( cursor.getInt32( 0 ) );
+			run.status = RunStatus( cursor.getInt32( 1 ) );
+			run.runDate = cursor.getDateTime( 2 );
+			auto hostId = cursor.getInt32( 3 );
+			auto hostIt = hosts.find( hostId );
+			assert( hostIt != hosts.end() );
+			run.host = hostIt->second.get();
+			run.totalTime = Microseconds{ uint64_t( cursor.getInt32( 4 ) ) };
+			run.avgTime = Microseconds{ uint64_t( cursor.getInt32( 5 ) ) };
+			run.lastTime = Microseconds{ uint64_t( cursor.getInt32( 6 ) ) };
+			result.insert( { run.runDate, run } );
 		}
 
 		return result;
@@ -1028,22 +1347,21 @@ namespace aria
 		rendererId->setValue( renderer->id );
 		hostId->setValue( host.id );
 		status->setValue( int32_t( maxStatus ) );
-		auto result = stmt->executeSelect();
+		auto cursor = stmt->executeCursor();
+		std::map< wxDateTime, TestTimes > ret;
 
-		if ( !result )
+		while ( cursor.next() )
 		{
-			throw std::runtime_error{ "Couldn't retrieve times list" };
+			ret.emplace( cursor.getDateTime( 0 )
+				, TestTimes{ &host
+					, Microseconds{ cursor.getInt32( 1 ) }
+					, Microseconds{ cursor.getInt32( 2 ) }
+					, Microseconds{ cursor.getInt32( 3 ) } } );
 		}
 
-		std::map< wxDateTime, TestTimes > ret;
-
-		for ( auto & row : *result )
+		if ( !cursor )
 		{
-			ret.emplace( row.getField( 0 ).getValue< db::DateTime >()
-				, TestTimes{ &host
-					, Microseconds{ row.getField( 1 ).getValue< int32_t >() }
-					, Microseconds{ row.getField( 2 ).getValue< int32_t >() }
-					, Microseconds{ row.getField( 3 ).getValue< int32_t >() } } );
+			throw std::runtime_error{ "Couldn't retrieve times list" };
 		}
 
 		return ret;
@@ -1056,31 +1374,55 @@ namespace aria
 		: m_plugin{ &plugin }
 		, m_config{ m_plugin->config }
 		, m_fileSystem{ fileSystem }
-		, m_database{ m_config.database }
-	{
+		, m_database{ m_config.database, m_config.databaseOptions }
+	{
+		// With a WAL journal, the latest changes must be written back to the database file before it is versioned.
+		// Checkpointing there only, rather than after each write, keeps the writes from syncing the database file.
+		m_fileSystem.setDatabase( m_config.database
+			, [this]()
+			{
+				// The commits are made under the file system lock, which the jobs take under the writer lock,
+				// so the writer lock can't be waited for here.
+				auto lock = std::unique_lock< std::recursive_mutex >( m_writerMutex, std::try_to_lock );
+				// A pending transaction, even from this thread, would leave the database file incomplete.
+				return lock.owns_lock()
+					&& !m_database.isInTransaction()
+					&& m_database.checkpoint();
+			} );
 	}
 
 	TestDatabase::~TestDatabase()
 	{
+		m_fileSystem.setDatabase( wxFileName{}, nullptr );
 	}
 
-	void TestDatabase::initialise( wxProgressDialog & progress
+	void TestDatabase::initialise( Progress & progress
 		, int & index )
 	{
 		// Necessary database initialisation
+		if ( !m_database.setJournalMode( m_config.databaseOptions.journalMode ) )
+		{
+			wxLogWarning( "Couldn't change the database journal mode." );
+		}
+		else
+		{
+			// Without WAL, readers would be blocked by the writes, so the writer connection is used.
+			m_useReaders = m_config.databaseOptions.journalMode == db::JournalMode::eWal;
+		}
+
 		m_checkTableExists = CheckTableExists{ m_database };
 		auto catRenInit = false;
 
 		if ( !m_checkTableExists.checkTable( "Test" ) )
 		{
 			doCreateV1( progress, index );
-			m_fileSystem.touchDb( m_config.database );
+			doTouchDb();
 		}
 
 		if ( !m_checkTableExists.checkTable( "TestsDatabase" ) )
 		{
 			doCreateV2( progress, index );
-			m_fileSystem.touchDb( m_config.database );
+			doTouchDb();
 			catRenInit = true;
 		}
 		else
@@ -1094,7 +1436,7 @@ namespace aria
 		if ( !m_checkTableExists.checkTable( "Keyword" ) )
 		{
 			doCreateV3( progress, index );
-			m_fileSystem.touchDb( m_config.database );
+			doTouchDb();
 		}
 		else
 		{
@@ -1131,6 +1473,21 @@ namespace aria
 			doCreateV6( progress, index );
 		}
 
+		if ( version < 7 )
+		{
+			doCreateV7( progress, index );
+		}
+
+		if ( version < 8 )
+		{
+			doCreateV8( progress, index );
+		}
+
+		if ( version < 9 )
+		{
+			doCreateV9( progress, index );
+		}
+
 		m_insertRun = InsertRun{ m_database };
 		m_updateRunStatus = UpdateRunStatus{ m_database };
 		m_updateTestIgnoreResult = UpdateTestIgnoreResult{ m_database };
@@ -1141,7 +1498,9 @@ namespace aria
 		m_listTests = ListTests{ m_database };
 		m_listLatestRun = ListLatestTestRun{ m_database };
 		m_listLatestRendererRuns = ListLatestRendererTests{ this };
-		m_listTestRuns = ListTestRuns{ this };
+		m_listLatestCategoryRuns = ListLatestCategoryTests{ m_database };
+		m_countLatestRendererRuns = CountLatestRendererTests{ m_database };
+		m_listTestRuns = ListTestRuns{ m_database };
 		m_deleteRun = DeleteRun{ this };
 		m_deleteTest = DeleteTest{ this };
 		m_deleteTestRuns = DeleteTestRuns{ this };
@@ -1165,7 +1524,7 @@ namespace aria
 		if ( m_config.initFromFolder )
 		{
 			doFillDatabase( progress, index );
-			m_fileSystem.touchDb( m_config.database );
+			doTouchDb();
 			catRenInit = true;
 		}
 
@@ -1229,6 +1588,11 @@ namespace aria
 		return m_database.beginTransaction( name );
 	}
 
+	std::unique_lock< std::recursive_mutex > TestDatabase::lockWriter()
+	{
+		return std::unique_lock< std::recursive_mutex >( m_writerMutex );
+	}
+
 	void TestDatabase::moveResultFile( DatabaseTest const & test
 		, TestStatus oldStatus
 		, TestStatus newStatus
@@ -1263,18 +1627,21 @@ namespace aria
 
 	Renderer TestDatabase::createRenderer( std::string const & name )
 	{
-		m_fileSystem.touchDb( m_config.database );
+		auto lock = lockWriter();
+		doTouchDb();
 		return testdb::getRenderer( name, m_renderers, m_insertRenderer );
 	}
 
 	Category TestDatabase::createCategory( std::string const & name )
 	{
-		m_fileSystem.touchDb( m_config.database );
+		auto lock = lockWriter();
+		doTouchDb();
 		return testdb::getCategory( name, m_categories, m_insertCategory );
 	}
 
 	void TestDatabase::deleteCategory( Category category )
 	{
+		auto lock = lockWriter();
 		auto categoryId = category->id;
 		wxLogMessage( "Deleting category tests runs" );
 		m_deleteCategoryTestsRuns.id->setValue( categoryId );
@@ -1292,13 +1659,14 @@ namespace aria
 				m_deleteCategory.stmt->executeUpdate();
 			}
 
-			m_fileSystem.touchDb( m_config.database );
+			doTouchDb();
 		}
 	}
 
 	void TestDatabase::updateCategoryName( Category category
 		, wxString const & name )
 	{
+		auto lock = lockWriter();
 		m_updateCategoryName.id->setValue( category->id );
 		m_updateCategoryName.name->setValue( makeStdString( name ) );
 
@@ -1310,13 +1678,14 @@ namespace aria
 			cat->name = name;
 			m_categories.emplace( name, std::move( cat ) );
 			wxLogMessage( wxString() << "Updated name for category " << category->id );
-			m_fileSystem.touchDb( m_config.database );
+			doTouchDb();
 		}
 	}
 
 	Keyword TestDatabase::createKeyword( std::string const & name )
 	{
-		m_fileSystem.touchDb( m_config.database );
+		auto lock = lockWriter();
+		doTouchDb();
 		return testdb::getKeyword( name, m_keywords, m_insertKeyword );
 	}
 
@@ -1327,7 +1696,7 @@ namespace aria
 		return result;
 	}
 
-	TestMap TestDatabase::listTests( wxProgressDialog & progress
+	TestMap TestDatabase::listTests( Progress & progress
 		, int & index )
 	{
 		TestMap result;
@@ -1337,30 +1706,37 @@ namespace aria
 
 	void TestDatabase::listTests( TestMap & result )
 	{
-		wxProgressDialog progress{ wxT( "Listing tests" )
-			, wxT( "Listing tests..." )
-			, 1
-			, nullptr };
-		int index = 0;
-		listTests( result, progress, index );
+		wxLogMessage( "Listing tests" );
+
+		if ( auto reader = doAcquireReader() )
+		{
+			reader->listCategories.listCategories( m_categories );
+			reader->listTests.listTests( m_categories, result );
+			doReleaseReader( std::move( reader ) );
+			return;
+		}
+
+		m_listCategories.listCategories( m_categories );
+		m_listTests.listTests( m_categories, result );
 	}
 
 	void TestDatabase::listTests( TestMap & result
-		, wxProgressDialog & progress
+		, Progress & progress
 		, int & index )
 	{
 		wxLogMessage( "Listing tests" );
-		progress.SetTitle( _( "Listing tests" ) );
-		progress.Update( index
+		progress.setTitle( _( "Listing tests" ) );
+		progress.update( index
 			, _( "Listing tests" )
 			+ wxT( "\n" ) + _( "..." ) );
-		progress.Fit();
+		progress.fit();
 		m_listCategories.listCategories( m_categories );
 		m_listTests.listTests( m_categories, result, progress, index );
 	}
 
 	void TestDatabase::deleteTest( uint32_t testId )
 	{
+		auto lock = lockWriter();
 		wxLogMessage( "Deleting test runs" );
 		m_deleteTestRuns.id->setValue( testId );
 
@@ -1370,7 +1746,7 @@ namespace aria
 			m_deleteTest.id->setValue( testId );
 			m_deleteTest.stmt->executeUpdate();
 
-			m_fileSystem.touchDb( m_config.database );
+			doTouchDb();
 		}
 	}
 
@@ -1382,7 +1758,7 @@ namespace aria
 	}
 
 	AllTestRuns TestDatabase::listLatestRuns( TestMap const & tests
-		, wxProgressDialog & progress
+		, Progress & progress
 		, int & index )
 	{
 		AllTestRuns result{ *this };
@@ -1393,23 +1769,20 @@ namespace aria
 	void TestDatabase::listLatestRuns( TestMap const & tests
 		, AllTestRuns & result )
 	{
-		wxProgressDialog progress{ wxT( "Listing latest runs" )
-			, wxT( "Listing latest runs..." )
-			, 1
-			, nullptr };
+		testdb::NoProgress progress;
 		int index = 0;
 		listLatestRuns( tests, result, progress, index );
 	}
 
 	void TestDatabase::listLatestRuns( TestMap const & tests
 		, AllTestRuns & result
-		, wxProgressDialog & progress
+		, Progress & progress
 		, int & index )
 	{
 		wxLogMessage( "Listing latest runs" );
-		progress.SetTitle( _( "Listing latest runs" ) );
-		progress.Update( index, _( "Listing latest runs\n..." ) );
-		progress.Fit();
+		progress.setTitle( _( "Listing latest runs" ) );
+		progress.update( index, _( "Listing latest runs\n..." ) );
+		progress.fit();
 
 		for ( auto & renderer : m_renderers )
 		{
@@ -1422,10 +1795,7 @@ namespace aria
 		, TestMap const & tests
 		, RendererTestRuns & result )
 	{
-		wxProgressDialog progress{ wxT( "Listing latest renderer runs" )
-			, wxT( "Listing latest renderer runs..." )
-			, 1
-			, nullptr };
+		testdb::NoProgress progress;
 		int index = 0;
 		listLatestRuns( renderer, tests, result, progress, index );
 	}
@@ -1433,52 +1803,104 @@ namespace aria
 	void TestDatabase::listLatestRuns( Renderer renderer
 		, TestMap const & tests
 		, RendererTestRuns & result
-		, wxProgressDialog & progress
+		, Progress & progress
 		, int & index )
 	{
 		wxLogMessage( "Listing latest renderer runs" );
-		progress.SetTitle( _( "Listing latest renderer runs" ) );
-		progress.Update( index, _( "Listing latest renderer runs\n..." ) );
-		progress.Fit();
+		progress.setTitle( _( "Listing latest renderer runs" ) );
+		progress.update( index, _( "Listing latest renderer runs\n..." ) );
+		progress.fit();
 		m_listLatestRendererRuns.listTests( tests, m_hosts, m_categories, renderer, result, progress, index );
 	}
 
+	DatabaseTestArray TestDatabase::listLatestRuns( Renderer renderer
+		, Category category
+		, TestArray const & tests
+		, RendererTestRuns & result )
+	{
+		wxLogMessage( wxString{} << "Listing latest runs for " << renderer->name << " - " << category->name );
+
+		if ( auto reader = doAcquireReader() )
+		{
+			auto ret = reader->listLatestCategoryRuns.listTests( tests, m_hosts, renderer, category, result );
+			doReleaseReader( std::move( reader ) );
+			return ret;
+		}
+
+		return m_listLatestCategoryRuns.listTests( tests, m_hosts, renderer, category, result );
+	}
+
+	void TestDatabase::countLatestRuns( Renderer renderer
+		, TestMap const & tests
+		, RendererTestsCounts & result )
+	{
+		wxLogMessage( wxString{} << "Counting latest runs for " << renderer->name );
+
+		if ( auto reader = doAcquireReader() )
+		{
+			reader->countLatestRendererRuns.countTests( tests, renderer, m_plugin->getEngineRefDate(), result );
+			doReleaseReader( std::move( reader ) );
+			return;
+		}
+
+		m_countLatestRendererRuns.countTests( tests, renderer, m_plugin->getEngineRefDate(), result );
+	}
+
 	RunMap TestDatabase::listRuns( int testId )
 	{
 		wxLogMessage( wxString{} << "Listing test " << testId << " runs" );
+
+		if ( auto reader = doAcquireReader() )
+		{
+			auto result = reader->listTestRuns.listRuns( m_hosts, testId );
+			doReleaseReader( std::move( reader ) );
+			return result;
+		}
+
 		return m_listTestRuns.listRuns( m_hosts, testId );
 	}
 
 	void TestDatabase::deleteRun( uint32_t runId )
 	{
+		auto lock = lockWriter();
 		wxLogMessage( wxString{} << "Deleting run " << runId );
 		m_deleteRun.id->setValue( int32_t( runId ) );
 		m_deleteRun.stmt->executeUpdate();
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
 	void TestDatabase::updateRunHost( uint32_t runId, int32_t hostId )
 	{
+		auto lock = lockWriter();
 		wxLogMessage( wxString{} << "Updating run host " << runId );
 		m_updateHost.runId->setValue( int32_t( runId ) );
 		m_updateHost.hostId->setValue( hostId );
 		m_updateHost.stmt->executeUpdate();
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
 	void TestDatabase::updateRunStatus( uint32_t runId, RunStatus status )
 	{
+		auto lock = lockWriter();
 		wxLogMessage( wxString{} << "Updating run status " << runId );
 		m_updateStatus.runId->setValue( int32_t( runId ) );
 		m_updateStatus.status->setValue( int32_t( status ) );
 		m_updateStatus.stmt->executeUpdate();
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
 	std::vector< Host const * > TestDatabase::listTestHosts( Test const & test
 		, Renderer const & renderer )
 	{
 		wxLogMessage( "Listing test runs hosts" );
+
+		if ( auto reader = doAcquireReader() )
+		{
+			auto result = reader->listTestHosts.list( test, renderer, m_hosts );
+			doReleaseReader( std::move( reader ) );
+			return result;
+		}
+
 		return m_listTestHosts.list( test, renderer, m_hosts );
 	}
 
@@ -1488,50 +1910,63 @@ namespace aria
 		, TestStatus maxStatus )
 	{
 		wxLogMessage( "Listing latest test times" );
+
+		if ( auto reader = doAcquireReader() )
+		{
+			auto result = reader->listAllTimes.listTimes( test, renderer, host, maxStatus );
+			doReleaseReader( std::move( reader ) );
+			return result;
+		}
+
 		return m_listAllTimes.listTimes( test, renderer, host, maxStatus );
 	}
 
 	void TestDatabase::insertTest( Test & test
 		, bool moveFiles )
 	{
+		auto lock = lockWriter();
 		test.id = m_insertTest.insert( test.category->id
 			, test.name );
 		wxLogMessage( wxString() << "Inserted: " + getDetails( test ) );
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
 	void TestDatabase::updateRunsEngineDate( db::DateTime const & date )
 	{
+		auto lock = lockWriter();
 		m_updateRunsEngineDate.engineDate->setValue( date );
 		m_updateRunsEngineDate.stmt->executeUpdate();
 		wxLogMessage( "Updated Engine date for all runs" );
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
 	void TestDatabase::updateTestCategory( Test const & test
 		, Category category )
 	{
+		auto lock = lockWriter();
 		m_updateTestCategory.categoryId->setValue( category->id );
 		m_updateTestCategory.id->setValue( test.id );
 		m_updateTestCategory.stmt->executeUpdate();
 		wxLogMessage( wxString() << "Updated category for test " + test.name );
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
 	void TestDatabase::updateTestName( Test const & test
 		, wxString const & name )
 	{
+		auto lock = lockWriter();
 		m_updateTestName.id->setValue( test.id );
 		m_updateTestName.name->setValue( makeStdString( name ) );
 		m_updateTestName.stmt->executeUpdate();
 		wxLogMessage( wxString() << "Updated name for test " << test.id );
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
 	Host * TestDatabase::getHost( std::string const & platformName
 		, std::string const & cpuName
 		, std::string const & gpuName )
 	{
+		auto lock = lockWriter();
 		auto platform = testdb::getIdValue( platformName, m_platforms, m_insertPlatform );
 		auto cpu = testdb::getIdValue( cpuName, m_cpus, m_insertCpu );
 		auto gpu = testdb::getIdValue( gpuName, m_gpus, m_insertGpu );
@@ -1556,84 +1991,195 @@ namespace aria
 		return it->second.get();
 	}
 
-	void TestDatabase::insertRun( TestRun & run
+	TestTimes TestDatabase::processTestOutputTimes( wxFileName const & timesFilePath )
+	{
+		TestTimes result{};
+
+		if ( timesFilePath.FileExists() )
+		{
+			{
+				std::ifstream file{ timesFilePath.GetFullPath().ToStdString() };
+
+				if ( file.is_open() )
+				{
+					std::string line;
+					auto lineIndex = 0u;
+					uint32_t t, a, l;
+					std::string platform, cpu, gpu;
+
+					while ( std::getline( file, line ) && lineIndex < 4u )
+					{
+						switch ( lineIndex )
+						{
+						case 0u:
+							platform = line;
+							break;
+						case 1u:
+							cpu = line;
+							break;
+						case 2u:
+							gpu = line;
+							break;
+						case 3u:
+							{
+								std::stringstream stream{ line };
+								stream >> t >> a >> l;
+							}
+							break;
+						default:
+							break;
+						}
+
+						++lineIndex;
+					}
+
+					result.host = getHost( platform, cpu, gpu );
+					result.total = Microseconds{ t };
+					result.avg = Microseconds{ a };
+					result.last = Microseconds{ l };
+				}
+			}
+			wxRemoveFile( timesFilePath.GetFullPath() );
+		}
+		else
+		{
+			result.host = getHost( "Unknown", "Unknown", "Unknown" );
+		}
+
+		return result;
+	}
+
+	void TestDatabase::insertRuns( std::span< TestRun * const > runs
 		, bool moveFiles )
 	{
-		run.id = m_insertRun.insert( run.test->id
-			, run.renderer->id
-			, run.runDate
-			, run.status
-			, run.engineDate
-			, run.testDate
-			, run.times.total
-			, run.times.avg
-			, run.times.last
-			, *run.times.host );
+		auto lock = lockWriter();
+		if ( runs.empty() )
+		{
+			return;
+		}
 
-		if ( moveFiles )
+		auto transaction = m_database.beginTransaction( "InsertRuns" );
+
+		if ( !transaction )
 		{
-			if ( run.status != TestStatus::eNotRun
-				&& run.status != TestStatus::eCrashed )
+			throw std::runtime_error{ "Couldn't begin a transaction." };
+		}
+
+		try
+		{
+			for ( auto run : runs )
 			{
-				auto srcFolder = m_config.test / getCompareFolder( run );
-				auto dstFolder = m_config.work / getResultFolder( run );
-				m_fileSystem.moveFile( run.test->name
-					, srcFolder
-					, dstFolder
-					, getCompareName( run )
-					, getResultName( run )
-					, false );
+				doInsertRun( *run, moveFiles );
 			}
 		}
+		catch ( std::exception & )
+		{
+			transaction.rollback();
+			throw;
+		}
+
+		transaction.commit();
+		doTouchDb();
+	}
+
+	void TestDatabase::flushRuns()
+	{
+		auto lock = lockWriter();
+		std::vector< QueuedRun > queued;
+		{
+			auto lock = std::unique_lock< std::mutex >( m_queuedRunsMutex );
+			queued = std::move( m_queuedRuns );
+			m_queuedRuns.clear();
+		}
+		std::vector< TestRun * > runs;
+		runs.reserve( queued.size() );
+
+		for ( auto & [test, run] : queued )
+		{
+			runs.push_back( &run );
+		}
+
+		insertRuns( runs );
+
+		for ( auto & [test, run] : queued )
+		{
+			test->m_test.id = run.id;
+		}
+	}
+
+	bool TestDatabase::isRunQueued( DatabaseTest const & test )
+	{
+		auto lock = std::unique_lock< std::mutex >( m_queuedRunsMutex );
+		return m_queuedRuns.end() != std::find_if( m_queuedRuns.begin()
+			, m_queuedRuns.end()
+			, [&test]( QueuedRun const & lookup )
+			{
+				return lookup.first == &test;
+			} );
+	}
+
+	void TestDatabase::insertRun( TestRun & run
+		, bool moveFiles )
+	{
+		auto lock = lockWriter();
+		doInsertRun( run, moveFiles );
+		doTouchDb();
+	}
 
-		wxLogMessage( wxString() << "Inserted: " + getDetails( run ) );
-		m_fileSystem.touchDb( m_config.database );
+	void TestDatabase::queueRun( DatabaseTest & test )
+	{
+		auto lock = std::unique_lock< std::mutex >( m_queuedRunsMutex );
+		m_queuedRuns.emplace_back( &test, test.m_test );
 	}
 
 	void TestDatabase::updateTestIgnoreResult( Test const & test
 		, bool ignore )
 	{
+		auto lock = lockWriter();
 		m_updateTestIgnoreResult.ignore->setValue( ignore ? 1 : 0 );
 		m_updateTestIgnoreResult.id->setValue( int32_t( test.id ) );
 		m_updateTestIgnoreResult.stmt->executeUpdate();
 		wxLogMessage( wxString() << "Updated ignore result for: " + getDetails( test ) );
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
 	void TestDatabase::updateRunStatus( TestRun const & run )
 	{
+		auto lock = lockWriter();
 		m_updateRunStatus.status->setValue( int32_t( run.status ) );
 		m_updateRunStatus.engineDate->setValue( run.engineDate );
 		m_updateRunStatus.testDate->setValue( run.testDate );
 		m_updateRunStatus.id->setValue( int32_t( run.id ) );
 		m_updateRunStatus.stmt->executeUpdate();
 		wxLogMessage( wxString() << "Updated status for: " + getDetails( run ) );
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
 	void TestDatabase::updateRunEngineDate( TestRun const & run )
 	{
+		auto lock = lockWriter();
 		m_updateRunEngineDate.engineDate->setValue( run.engineDate );
 		m_updateRunEngineDate.id->setValue( int32_t( run.id ) );
 		m_updateRunEngineDate.stmt->executeUpdate();
 		wxLogMessage( wxString() << "Updated Engine date for: " + getDetails( run ) );
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
 	void TestDatabase::updateRunTestDate( TestRun const & run )
 	{
+		auto lock = lockWriter();
 		m_updateRunSceneDate.testDate->setValue( m_plugin->getTestDate( run ) );
 		m_updateRunSceneDate.id->setValue( int32_t( run.id ) );
 		m_updateRunSceneDate.stmt->executeUpdate();
 		wxLogMessage( wxString() << "Updated Scene date for: " + getDetails( run ) );
-		m_fileSystem.touchDb( m_config.database );
+		doTouchDb();
 	}
 
-	void TestDatabase::doCreateV1( wxProgressDialog & progress, int & index )
+	void TestDatabase::doCreateV1( Progress & progress, int & index )
 	{
-		auto saveRange = progress.GetRange();
+		auto saveRange = progress.getRange();
 		auto saveIndex = index;
-		progress.SetTitle( _( "Creating tests database" ) + wxT( " V3" ) );
+		progress.setTitle( _( "Creating tests database" ) + wxT( " V3" ) );
 		index = 0;
 		auto transaction = m_database.beginTransaction( "DatabaseUpdate" );
 
@@ -1657,29 +2203,29 @@ namespace aria
 			createTableTest += ");";
 			m_database.executeUpdate( createTableTest );
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Creating tests database" )
 				+ wxT( "\n" ) + _( "Validating changes" ) );
-			progress.Fit();
+			progress.fit();
 			transaction.commit();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 		}
 		catch ( std::exception & )
 		{
 			transaction.rollback();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 			throw;
 		}
 	}
 
-	void TestDatabase::doCreateV2( wxProgressDialog & progress, int & index )
+	void TestDatabase::doCreateV2( Progress & progress, int & index )
 	{
 		static int constexpr NonTestsCount = 7;
-		auto saveRange = progress.GetRange();
+		auto saveRange = progress.getRange();
 		auto saveIndex = index;
-		progress.SetTitle( _( "Updating tests database to V3" ) );
+		progress.setTitle( _( "Updating tests database to V3" ) );
 		index = 0;
 		auto transaction = m_database.beginTransaction( "DatabaseUpdate" );
 
@@ -1690,11 +2236,11 @@ namespace aria
 
 		try
 		{
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Creating tests database" ) );
-			progress.Fit();
-			progress.SetRange( NonTestsCount );
+			progress.fit();
+			progress.setRange( NonTestsCount );
 			std::string query = "CREATE TABLE TestsDatabase( Id INTEGER PRIMARY KEY, Version INTEGER );";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -1711,10 +2257,10 @@ namespace aria
 
 			{
 				// Renderer table
-				progress.Update( index++
+				progress.update( index++
 					, _( "Updating tests database" )
 					+ wxT( "\n" ) + _( "Creating Renderer table" ) );
-				progress.Fit();
+				progress.fit();
 				query = "CREATE TABLE Renderer";
 				query += "( Id INTEGER PRIMARY KEY\n";
 				query += "\t, Name VARCHAR(10)\n";
@@ -1730,10 +2276,10 @@ namespace aria
 
 			{
 				// Category table
-				progress.Update( index++
+				progress.update( index++
 					, _( "Updating tests database" )
 					+ wxT( "\n" ) + _( "Creating Category table" ) );
-				progress.Fit();
+				progress.fit();
 
 				query = "CREATE TABLE Category";
 				query += "( Id INTEGER PRIMARY KEY\n";
@@ -1748,10 +2294,10 @@ namespace aria
 				m_insertCategory = InsertCategory{ m_database };
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Creating Test table" ) );
-			progress.Fit();
+			progress.fit();
 
 			query = "ALTER TABLE Test\n";
 			query += "RENAME TO TestOld;";
@@ -1790,10 +2336,10 @@ namespace aria
 
 			m_insertTest = InsertTest{ m_database };
 			m_insertRunV2 = InsertRunV2{ m_database };
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Listing tests" ) );
-			progress.Fit();
+			progress.fit();
 
 			query = "SELECT Category, Name, Renderer, RunDate, Status, EngineDate, SceneDate\n";
 			query += "FROM TestOld\n";
@@ -1805,13 +2351,13 @@ namespace aria
 				throw std::runtime_error{ "Couldn't list existing tests." };
 			}
 
-			progress.SetRange( NonTestsCount + int( testsList->size() ) );
+			progress.setRange( NonTestsCount + int( testsList->size() ) );
 			std::vector< TestPtr > tests;
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( " - " ) + _( "Listing tests" )
 				+ wxT( "\n" ) + _( "..." ) );
-			progress.Fit();
+			progress.fit();
 
 			std::string prvCatName;
 			std::string prvTestName;
@@ -1823,11 +2369,11 @@ namespace aria
 				auto testName = testInstance.getField( 1u ).getValue< std::string >();
 				auto rendName = testInstance.getField( 2u ).getValue< std::string >();
 				auto runDate = testInstance.getField( 3u ).getValue< db::DateTime >();
-				progress.Update( index++
+				progress.update( index++
 					, _( "Updating tests database" )
 					+ wxT( " - " ) + _( "Listing tests" )
 					+ wxT( "\n" ) + getProgressDetails( catName, testName, rendName, runDate ) );
-				progress.Fit();
+				progress.fit();
 
 				if ( catName != prvCatName
 					|| testName != prvTestName )
@@ -1852,30 +2398,30 @@ namespace aria
 				throw std::runtime_error{ "Couldn't drop TestOld table." };
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Validating changes" ) );
-			progress.Fit();
+			progress.fit();
 
 			transaction.commit();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 		}
 		catch ( std::exception & )
 		{
 			transaction.rollback();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 			throw;
 		}
 	}
 
-	void TestDatabase::doCreateV3( wxProgressDialog & progress, int & index )
+	void TestDatabase::doCreateV3( Progress & progress, int & index )
 	{
 		static int constexpr NonTestsCount = 7;
-		auto saveRange = progress.GetRange();
+		auto saveRange = progress.getRange();
 		auto saveIndex = index;
-		progress.SetTitle( _( "Updating tests database to V3" ) );
+		progress.setTitle( _( "Updating tests database to V3" ) );
 		index = 0;
 		auto transaction = m_database.beginTransaction( "DatabaseUpdate" );
 
@@ -1886,11 +2432,11 @@ namespace aria
 
 		try
 		{
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Creating Keyword table" ) );
-			progress.Fit();
-			progress.SetRange( NonTestsCount );
+			progress.fit();
+			progress.setRange( NonTestsCount );
 			std::string query = "CREATE TABLE Keyword( Id INTEGER PRIMARY KEY, Name VARCHAR(50) );";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -1905,10 +2451,10 @@ namespace aria
 				testdb::getKeyword( keyword, m_keywords, m_insertKeyword );
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Creating CategoryKeyword table" ) );
-			progress.Fit();
+			progress.fit();
 			query = "CREATE TABLE CategoryKeyword( CategoryId INTEGER, KeywordId INTEGER );";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -1917,10 +2463,10 @@ namespace aria
 			}
 
 			m_insertCategoryKeyword = InsertCategoryKeyword{ m_database };
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Creating TestKeyword table" ) );
-			progress.Fit();
+			progress.fit();
 			query = "CREATE TABLE TestKeyword( TestId INTEGER, KeywordId INTEGER );";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -1929,10 +2475,10 @@ namespace aria
 			}
 
 			m_insertTestKeyword = InsertTestKeyword{ m_database };
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Listing test names" ) );
-			progress.Fit();
+			progress.fit();
 			query = "SELECT Id, Name FROM Test ORDER BY Name;";
 			auto testNames = m_database.executeSelect( query );
 
@@ -1943,10 +2489,10 @@ namespace aria
 
 			doAssignTestKeywords( *testNames, progress, index );
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Updating database version number" ) );
-			progress.Fit();
+			progress.fit();
 			query = "UPDATE TestsDatabase SET Version=3;";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -1955,29 +2501,29 @@ namespace aria
 			}
 
 			m_getDatabaseVersion = GetDatabaseVersion{ m_database };
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Validating changes" ) );
-			progress.Fit();
+			progress.fit();
 			transaction.commit();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 		}
 		catch ( std::exception & )
 		{
 			transaction.rollback();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 			throw;
 		}
 	}
 
-	void TestDatabase::doCreateV4( wxProgressDialog & progress, int & index )
+	void TestDatabase::doCreateV4( Progress & progress, int & index )
 	{
 		static int constexpr NonTestsCount = 2;
-		auto saveRange = progress.GetRange();
+		auto saveRange = progress.getRange();
 		auto saveIndex = index;
-		progress.SetTitle( _( "Updating tests database to V4" ) );
+		progress.setTitle( _( "Updating tests database to V4" ) );
 		index = 0;
 		auto transaction = m_database.beginTransaction( "DatabaseUpdate4" );
 
@@ -1988,11 +2534,11 @@ namespace aria
 
 		try
 		{
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Updating version number" ) );
-			progress.Fit();
-			progress.SetRange( NonTestsCount );
+			progress.fit();
+			progress.setRange( NonTestsCount );
 			std::string query = "UPDATE TestsDatabase SET Version=4;";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -2021,29 +2567,29 @@ namespace aria
 				throw std::runtime_error{ "Couldn't add LastFrameTime column." };
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Validating changes" ) );
-			progress.Fit();
+			progress.fit();
 			transaction.commit();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 		}
 		catch ( std::exception & )
 		{
 			transaction.rollback();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 			throw;
 		}
 	}
 
-	void TestDatabase::doCreateV5( wxProgressDialog & progress, int & index )
+	void TestDatabase::doCreateV5( Progress & progress, int & index )
 	{
 		static int constexpr UpdatesCount = 6;
-		auto saveRange = progress.GetRange();
+		auto saveRange = progress.getRange();
 		auto saveIndex = index;
-		progress.SetTitle( _( "Updating tests database to V5" ) );
+		progress.setTitle( _( "Updating tests database to V5" ) );
 		index = 0;
 		auto transaction = m_database.beginTransaction( "DatabaseUpdate5" );
 
@@ -2054,11 +2600,11 @@ namespace aria
 
 		try
 		{
-			progress.SetRange( UpdatesCount );
-			progress.Update( index++
+			progress.setRange( UpdatesCount );
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Updating version number" ) );
-			progress.Fit();
+			progress.fit();
 			std::string query = "UPDATE TestsDatabase SET Version=5;";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -2066,10 +2612,10 @@ namespace aria
 				throw std::runtime_error{ "Couldn't update version number." };
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Creating Platform table" ) );
-			progress.Fit();
+			progress.fit();
 			query = "CREATE TABLE Platform( Id INTEGER PRIMARY KEY, Name VARCHAR(128) );";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -2089,10 +2635,10 @@ namespace aria
 				testdb::getPlatform( platform, m_platforms, m_insertPlatform );
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Creating CPU table" ) );
-			progress.Fit();
+			progress.fit();
 			query = "CREATE TABLE CPU( Id INTEGER PRIMARY KEY, Name VARCHAR(256) );";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -2113,10 +2659,10 @@ namespace aria
 				testdb::getCpu( cpu, m_cpus, m_insertCpu );
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Creating GPU table" ) );
-			progress.Fit();
+			progress.fit();
 			query = "CREATE TABLE GPU( Id INTEGER PRIMARY KEY, Name VARCHAR(256) );";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -2137,10 +2683,10 @@ namespace aria
 				testdb::getGpu( gpu, m_gpus, m_insertGpu );
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Creating Host table" ) );
-			progress.Fit();
+			progress.fit();
 			query = "CREATE TABLE Host( Id INTEGER PRIMARY KEY, PlatformId INTEGER, CpuId INTEGER, GpuId INTEGER );";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -2167,39 +2713,39 @@ namespace aria
 
 			auto host = getHost( "Unknown", "Unknown", "Unknown" );
 			query = "ALTER TABLE TestRun ADD COLUMN HostId INTEGER DEFAULT " + std::to_string( host->id ) + ";";
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Adding CpuId column" ) );
-			progress.Fit();
+			progress.fit();
 
 			if ( !m_database.executeUpdate( query ) )
 			{
 				throw std::runtime_error{ "Couldn't add CpuId column." };
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Validating changes" ) );
-			progress.Fit();
+			progress.fit();
 			transaction.commit();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 		}
 		catch ( std::exception & )
 		{
 			transaction.rollback();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 			throw;
 		}
 	}
 
-	void TestDatabase::doCreateV6( wxProgressDialog & progress, int & index )
+	void TestDatabase::doCreateV6( Progress & progress, int & index )
 	{
 		static int constexpr UpdatesCount = 7;
-		auto saveRange = progress.GetRange();
+		auto saveRange = progress.getRange();
 		auto saveIndex = index;
-		progress.SetTitle( _( "Updating tests database to V5" ) );
+		progress.setTitle( _( "Updating tests database to V5" ) );
 		index = 0;
 		auto transaction = m_database.beginTransaction( "DatabaseUpdate6" );
 
@@ -2210,11 +2756,11 @@ namespace aria
 
 		try
 		{
-			progress.SetRange( UpdatesCount );
-			progress.Update( index++
+			progress.setRange( UpdatesCount );
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Clearing old keywords" ) );
-			progress.Fit();
+			progress.fit();
 			std::string query = "DELETE FROM Keyword;";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -2222,10 +2768,10 @@ namespace aria
 				throw std::runtime_error{ "Couldn't delete old keywords." };
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Clearing old category keywords" ) );
-			progress.Fit();
+			progress.fit();
 			query = "DELETE FROM CategoryKeyword;";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -2233,10 +2779,10 @@ namespace aria
 				throw std::runtime_error{ "Couldn't delete old category keywords." };
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Clearing old test keywords" ) );
-			progress.Fit();
+			progress.fit();
 			query = "DELETE FROM TestKeyword;";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -2244,10 +2790,10 @@ namespace aria
 				throw std::runtime_error{ "Couldn't delete old test keywords." };
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Listing test names" ) );
-			progress.Fit();
+			progress.fit();
 			query = "SELECT Id, Name FROM Test ORDER BY Name;";
 			auto testNames = m_database.executeSelect( query );
 
@@ -2256,10 +2802,10 @@ namespace aria
 				throw std::runtime_error{ "Couldn't list test names." };
 			}
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Generating keywords list" ) );
-			progress.Fit();
+			progress.fit();
 			wxArrayString names;
 			auto uniqueNames = testdb::defaultKeywords;
 			auto addName = [&uniqueNames]( std::string_view name )
@@ -2323,28 +2869,25 @@ namespace aria
 				selections.push_back( int( selections.size() ) );
 			}
 
-			wxMultiChoiceDialog dialog{ nullptr
+			if ( !progress.select( wxT( "Select valid keywords" )
 				, wxT( "Selected keywords will be registered into the database" )
-				, wxT( "Select valid keywords" )
-				, names };
-			dialog.SetSelections( selections );
-
-			if ( dialog.ShowModal() != wxID_OK )
+				, names
+				, selections ) )
 			{
 				throw std::runtime_error{ "No keyword was selected." };
 			}
 
-			for ( auto i : dialog.GetSelections() )
+			for ( auto i : selections )
 			{
 				testdb::getKeyword( makeStdString( names[size_t( i )] ), m_keywords, m_insertKeyword );
 			}
 
 			doAssignTestKeywords( *testNames, progress, index );
 
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Updating version number" ) );
-			progress.Fit();
+			progress.fit();
 			query = "UPDATE TestsDatabase SET Version=6;";
 
 			if ( !m_database.executeUpdate( query ) )
@@ -2352,23 +2895,357 @@ namespace aria
 				throw std::runtime_error{ "Couldn't update version number." };
 			}
 
-			progress.Update( index++
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Validating changes" ) );
+			progress.fit();
+			transaction.commit();
+			progress.setRange( saveRange );
+			index = saveIndex;
+		}
+		catch ( std::exception & )
+		{
+			transaction.rollback();
+			progress.setRange( saveRange );
+			index = saveIndex;
+			throw;
+		}
+	}
+
+	void TestDatabase::doCreateV7( Progress & progress, int & index )
+	{
+		static int constexpr UpdatesCount = 3;
+		auto saveRange = progress.getRange();
+		auto saveIndex = index;
+		progress.setTitle( _( "Updating tests database to V7" ) );
+		index = 0;
+		auto transaction = m_database.beginTransaction( "DatabaseUpdate7" );
+
+		if ( !transaction )
+		{
+			throw std::runtime_error{ "Couldn't begin a transaction." };
+		}
+
+		try
+		{
+			progress.setRange( UpdatesCount );
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Creating imported folders table" ) );
+			progress.fit();
+			// Keeps the modification time of the folders imported by updateRunsCache,
+			// so that unchanged folders aren't listed again.
+			std::string query = "CREATE TABLE ImportedFolder( Path VARCHAR(1024) PRIMARY KEY, ModificationTime DATETIME );";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't create ImportedFolder table." };
+			}
+
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Updating version number" ) );
+			progress.fit();
+			query = "UPDATE TestsDatabase SET Version=7;";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't update version number." };
+			}
+
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Validating changes" ) );
+			progress.fit();
+			transaction.commit();
+			progress.setRange( saveRange );
+			index = saveIndex;
+		}
+		catch ( std::exception & )
+		{
+			transaction.rollback();
+			progress.setRange( saveRange );
+			index = saveIndex;
+			throw;
+		}
+	}
+
+	void TestDatabase::doCreateV8( Progress & progress, int & index )
+	{
+		static int constexpr UpdatesCount = 5;
+		auto saveRange = progress.getRange();
+		auto saveIndex = index;
+		progress.setTitle( _( "Updating tests database to V8" ) );
+		index = 0;
+		auto transaction = m_database.beginTransaction( "DatabaseUpdate8" );
+
+		if ( !transaction )
+		{
+			throw std::runtime_error{ "Couldn't begin a transaction." };
+		}
+
+		try
+		{
+			progress.setRange( UpdatesCount );
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Creating test runs indices" ) );
+			progress.fit();
+			std::string query = "CREATE INDEX IF NOT EXISTS TestRunByTestRendererDate ON TestRun( TestId, RendererId, RunDate );";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't create TestRunByTestRendererDate index." };
+			}
+
+			query = "CREATE INDEX IF NOT EXISTS TestRunByTestRendererHostStatus ON TestRun( TestId, RendererId, HostId, Status );";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't create TestRunByTestRendererHostStatus index." };
+			}
+
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Creating latest runs table" ) );
+			progress.fit();
+			query = "CREATE TABLE LatestRun( TestId INTEGER, RendererId INTEGER, RunId INTEGER, PRIMARY KEY( TestId, RendererId ) );";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't create LatestRun table." };
+			}
+
+			query = "INSERT INTO LatestRun (TestId, RendererId, RunId)\n";
+			query += "SELECT TestId, RendererId, Id FROM (SELECT TestId, RendererId, Id, MAX(RunDate) FROM TestRun GROUP BY TestId, RendererId);";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't fill LatestRun table." };
+			}
+
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Creating latest runs triggers" ) );
+			progress.fit();
+			// Each trigger recomputes the latest run of the affected (test, renderer) pairs,
+			// which is a single lookup in the TestRunByTestRendererDate index.
+			auto selectLatest = []( std::string const & row )
+				{
+					return "INSERT OR REPLACE INTO LatestRun (TestId, RendererId, RunId)\n"
+						"SELECT TestId, RendererId, Id FROM TestRun WHERE TestId=" + row + ".TestId AND RendererId=" + row + ".RendererId ORDER BY RunDate DESC, Id DESC LIMIT 1;\n";
+				};
+			auto deleteLatest = []( std::string const & row )
+				{
+					return "DELETE FROM LatestRun WHERE TestId=" + row + ".TestId AND RendererId=" + row + ".RendererId;\n";
+				};
+			query = "CREATE TRIGGER LatestRunInsert AFTER INSERT ON TestRun\n";
+			query += "BEGIN\n";
+			query += selectLatest( "NEW" );
+			query += "END;";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't create LatestRunInsert trigger." };
+			}
+
+			query = "CREATE TRIGGER LatestRunUpdate AFTER UPDATE OF TestId, RendererId, RunDate ON TestRun\n";
+			query += "BEGIN\n";
+			query += deleteLatest( "OLD" );
+			query += selectLatest( "OLD" );
+			query += selectLatest( "NEW" );
+			query += "END;";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't create LatestRunUpdate trigger." };
+			}
+
+			query = "CREATE TRIGGER LatestRunDelete AFTER DELETE ON TestRun\n";
+			query += "BEGIN\n";
+			query += deleteLatest( "OLD" );
+			query += selectLatest( "OLD" );
+			query += "END;";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't create LatestRunDelete trigger." };
+			}
+
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Updating version number" ) );
+			progress.fit();
+			query = "UPDATE TestsDatabase SET Version=8;";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't update version number." };
+			}
+
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Validating changes" ) );
+			progress.fit();
+			transaction.commit();
+			progress.setRange( saveRange );
+			index = saveIndex;
+		}
+		catch ( std::exception & )
+		{
+			transaction.rollback();
+			progress.setRange( saveRange );
+			index = saveIndex;
+			throw;
+		}
+	}
+
+	void TestDatabase::doCreateV9( Progress & progress, int & index )
+	{
+		static int constexpr UpdatesCount = 4;
+		auto saveRange = progress.getRange();
+		auto saveIndex = index;
+		progress.setTitle( _( "Updating tests database to V9" ) );
+		index = 0;
+		auto transaction = m_database.beginTransaction( "DatabaseUpdate9" );
+
+		if ( !transaction )
+		{
+			throw std::runtime_error{ "Couldn't begin a transaction." };
+		}
+
+		try
+		{
+			progress.setRange( UpdatesCount );
+			// Dates were stored as local time strings, they become seconds since epoch.
+			auto convertDates = [this]( std::string const & table
+				, std::string const & column )
+				{
+					auto query = "UPDATE " + table + " SET " + column + "=CAST(strftime('%s', " + column + ", 'utc') AS INTEGER) WHERE typeof(" + column + ")='text';";
+
+					if ( !m_database.executeUpdate( query ) )
+					{
+						throw std::runtime_error{ "Couldn't convert " + table + "." + column + " column." };
+					}
+				};
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Converting test runs dates" ) );
+			progress.fit();
+			convertDates( "TestRun", "RunDate" );
+			convertDates( "TestRun", "EngineDate" );
+			convertDates( "TestRun", "SceneDate" );
+
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Converting imported folders dates" ) );
+			progress.fit();
+
+			convertDates( "ImportedFolder", "ModificationTime" );
+
+			progress.update( index++
+				, _( "Updating tests database" )
+				+ wxT( "\n" ) + _( "Updating version number" ) );
+			progress.fit();
+			std::string query = "UPDATE TestsDatabase SET Version=9;";
+
+			if ( !m_database.executeUpdate( query ) )
+			{
+				throw std::runtime_error{ "Couldn't update version number." };
+			}
+
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Validating changes" ) );
-			progress.Fit();
+			progress.fit();
 			transaction.commit();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 		}
 		catch ( std::exception & )
 		{
 			transaction.rollback();
-			progress.SetRange( saveRange );
+			progress.setRange( saveRange );
 			index = saveIndex;
 			throw;
 		}
 	}
 
+	void TestDatabase::doInsertRun( TestRun & run
+		, bool moveFiles )
+	{
+		run.id = m_insertRun.insert( run.test->id
+			, run.renderer->id
+			, run.runDate
+			, run.status
+			, run.engineDate
+			, run.testDate
+			, run.times.total
+			, run.times.avg
+			, run.times.last
+			, *run.times.host );
+
+		if ( moveFiles )
+		{
+			if ( run.status != TestStatus::eNotRun
+				&& run.status != TestStatus::eCrashed )
+			{
+				auto srcFolder = m_config.test / getCompareFolder( run );
+				auto dstFolder = m_config.work / getResultFolder( run );
+				m_fileSystem.moveFile( run.test->name
+					, srcFolder
+					, dstFolder
+					, getCompareName( run )
+					, getResultName( run )
+					, false );
+			}
+		}
+
+		wxLogMessage( wxString() << "Inserted: " + getDetails( run ) );
+	}
+
+	void TestDatabase::doTouchDb()
+	{
+		m_fileSystem.touchDb();
+	}
+
+	TestDatabase::ReadConnectionPtr TestDatabase::doAcquireReader()
+	{
+		if ( !m_useReaders )
+		{
+			return nullptr;
+		}
+
+		{
+			auto lock = std::unique_lock< std::mutex >( m_readersMutex );
+
+			if ( !m_readers.empty() )
+			{
+				auto result = std::move( m_readers.back() );
+				m_readers.pop_back();
+				return result;
+			}
+		}
+
+		try
+		{
+			return std::make_unique< ReadConnection >( m_config.database
+				, m_config.databaseOptions );
+		}
+		catch ( std::exception & exc )
+		{
+			wxLogWarning( wxString{} << "Couldn't open a read-only database connection: " << exc.what() );
+			m_useReaders = false;
+			return nullptr;
+		}
+	}
+
+	void TestDatabase::doReleaseReader( ReadConnectionPtr reader )
+	{
+		auto lock = std::unique_lock< std::mutex >( m_readersMutex );
+		m_readers.push_back( std::move( reader ) );
+	}
+
 	void TestDatabase::doUpdateCategories()
 	{
 		for ( auto & category : m_categories )
@@ -2385,7 +3262,7 @@ namespace aria
 		}
 	}
 
-	void TestDatabase::doListCategories( wxProgressDialog & progress
+	void TestDatabase::doListCategories( Progress & progress
 		, int & index )
 	{
 		auto testFiles = testdb::listTestFiles( *m_plugin, m_config.test );
@@ -2393,57 +3270,124 @@ namespace aria
 		testdb::NodeArray nodes;
 		wxArrayString choices;
 		testFiles.flattenDirs( tmp, nodes, choices );
-		wxMultiChoiceDialog choice{ nullptr
-			, _( "Select the folders from which tests are imported" )
-			, _( "Folder selection" )
-			, choices };
+		wxArrayInt sel;
 
-		if ( choice.ShowModal() != wxID_OK )
+		if ( !progress.select( _( "Folder selection" )
+			, _( "Select the folders from which tests are imported" )
+			, choices
+			, sel ) )
 		{
 			return;
 		}
 
-		auto sel = choice.GetSelections();
-
 		TestMap result;
 		doUpdateCategories();
 		wxLogMessage( "Listing Test files" );
-		progress.SetTitle( _( "Listing Test files" ) );
-		progress.SetRange( progress.GetRange() + int( sel.size() ) );
-		progress.Update( index, _( "Listing Test files\n..." ) );
-		progress.Fit();
+		progress.setTitle( _( "Listing Test files" ) );
+		progress.setRange( progress.getRange() + int( sel.size() ) );
+		progress.update( index, _( "Listing Test files\n..." ) );
+		progress.fit();
+		auto transaction = m_database.beginTransaction( "ImportFolders" );
+
+		if ( !transaction )
+		{
+			throw std::runtime_error{ "Couldn't begin a transaction." };
+		}
+
+		auto importedFolders = testdb::listImportedFolders( m_database );
+		testdb::CheckRunExists checkRun{ m_database };
+		testdb::UpdateImportedFolder updateFolder{ m_database };
+		std::vector< testdb::ScannedCategory > scanned;
 
 		for ( auto selection : sel )
 		{
 			auto categoryName = choices[size_t( selection )];
-			auto categoryPath = m_config.test / categoryName;
-			progress.Update( index++
-				, _( "Listing Test files" )
-				+ wxT( "\n" ) + wxT( "- Category: " ) + categoryName + wxT( "..." ) );
-			progress.Fit();
-			auto category = testdb::getCategory( makeStdString( categoryName ), m_categories, m_insertCategory );
-			result.emplace( category
-				, testdb::listCategoryTestFiles( *m_plugin
-					, m_config
-					, m_insertRenderer
-					, m_insertTest
-					, m_insertRunV2
-					, categoryPath
-					, category
-					, *nodes[size_t( selection )]
-					, m_renderers ) );
-		}
-	}
-
-	void TestDatabase::doFillDatabase( wxProgressDialog & progress
+			scanned.push_back( { categoryName
+				, m_config.test / categoryName
+				, nodes[size_t( selection )] } );
+		}
+
+		// Folders are scanned on worker threads, the categories are written to the database
+		// by this thread, in selection order, as soon as their scan is done.
+		std::vector< std::promise< void > > scans( scanned.size() );
+		std::atomic_size_t next{};
+		std::vector< std::thread > workers;
+		auto workersCount = std::min( size_t( std::max( 1u, std::thread::hardware_concurrency() ) )
+			, scanned.size() );
+
+		for ( size_t i = 0u; i < workersCount; ++i )
+		{
+			workers.emplace_back( [&scanned, &scans, &next, &importedFolders]()
+				{
+					for ( auto current = next++; current < scanned.size(); current = next++ )
+					{
+						try
+						{
+							testdb::scanCategory( scanned[current], importedFolders );
+							scans[current].set_value();
+						}
+						catch ( ... )
+						{
+							scans[current].set_exception( std::current_exception() );
+						}
+					}
+				} );
+		}
+
+		try
+		{
+			for ( size_t i = 0u; i < scanned.size(); ++i )
+			{
+				auto & categoryScan = scanned[i];
+				progress.update( index++
+					, _( "Listing Test files" )
+					+ wxT( "\n" ) + wxT( "- Category: " ) + categoryScan.name + wxT( "..." ) );
+				progress.fit();
+				scans[i].get_future().get();
+				auto category = testdb::getCategory( makeStdString( categoryScan.name ), m_categories, m_insertCategory );
+				result.emplace( category
+					, testdb::writeCategory( *m_plugin
+						, m_database
+						, m_insertRenderer
+						, m_insertTest
+						, m_insertRunV2
+						, checkRun
+						, updateFolder
+						, categoryScan
+						, category
+						, m_renderers ) );
+			}
+		}
+		catch ( std::exception & )
+		{
+			next = scanned.size();
+
+			for ( auto & worker : workers )
+			{
+				worker.join();
+			}
+
+			transaction.rollback();
+			throw;
+		}
+
+		for ( auto & worker : workers )
+		{
+			worker.join();
+		}
+
+		transaction.commit();
+	}
+
+	void TestDatabase::doFillDatabase( Progress & progress
 		, int & index )
 	{
 		doListCategories( progress, index );
 	}
 
-	void TestDatabase::doAssignTestKeywords( db::Result const & testNames, wxProgressDialog & progress, int & index )
+	void TestDatabase::doAssignTestKeywords( db::Result const & testNames, Progress & progress, int & index )
 	{
-		progress.SetRange( int( progress.GetRange() + testNames.size() ) );
+		progress.setRange( int( progress.getRange() + testNames.size() ) );
 		auto findSubstr = []( const std::string & str1
 			, const std::string & str2 )
 			{
@@ -2467,13 +3411,13 @@ namespace aria
 			auto id = test.getField( 0 ).getValue< int32_t >();
 			auto name = test.getField( 1 ).getValue< std::string >();
 #if defined( _WIN32 )
-			progress.Update( index++
+			progress.update( index++
 				, _( "Updating tests database" )
 				+ wxT( "\n" ) + _( "Assigning keyword to test" )
 				+ wxT( "\n" ) + _( "- Test:" ) + name );
-			progress.Fit();
+			progress.fit();
 #else
-			progress.Update( index++ );
+			progress.update( index++ );
 #endif
 
 			for ( auto & keyword : m_keywords )
@@ -0,0 +1,312 @@
+#include "FileSystem/FileDateCache.hpp"
+
+#include "AriaLib/BeginExternHeaderGuard.hpp"
+#include <wx/fswatcher.h>
+#include <wx/log.h>
+#include "AriaLib/EndExternHeaderGuard.hpp"
+
+namespace aria
+{
+	//*********************************************************************************************
+
+	namespace filedt
+	{
+		static auto constexpr PollPeriod = std::chrono::milliseconds{ 2000 };
+		static int constexpr WatchFlags = wxFSW_EVENT_CREATE | wxFSW_EVENT_DELETE | wxFSW_EVENT_RENAME | wxFSW_EVENT_MODIFY;
+
+		static wxString getKey( wxFileName file )
+		{
+			file.Normalize( wxPATH_NORM_DOTS | wxPATH_NORM_ABSOLUTE | wxPATH_NORM_TILDE );
+			return file.GetFullPath();
+		}
+
+		static bool isInFolder( wxString const & path
+			, wxString const & folder )
+		{
+			return path == folder
+				|| path.StartsWith( folder + wxFileName::GetPathSeparator() );
+		}
+	}
+
+	//*********************************************************************************************
+
+	FileDateCache::FileDateCache()
+	{
+	}
+
+	FileDateCache::~FileDateCache()
+	{
+		{
+			std::lock_guard< std::mutex > lock{ m_mutex };
+			m_stopped = true;
+		}
+		m_pollCondition.notify_all();
+
+		if ( m_poller.joinable() )
+		{
+			m_poller.join();
+		}
+
+		m_watcher.reset();
+	}
+
+	db::DateTime FileDateCache::get( wxFileName const & file )
+	{
+		auto key = filedt::getKey( file );
+		std::lock_guard< std::mutex > lock{ m_mutex };
+		auto it = m_dates.find( key );
+
+		if ( it != m_dates.end() )
+		{
+			return it->second;
+		}
+
+		auto result = getFileDate( wxFileName{ key } );
+		m_dates.emplace( key, result );
+		auto folder = wxFileName{ key }.GetPath();
+
+		if ( m_folders.insert( folder ).second )
+		{
+			m_pendingFolders.push_back( folder );
+			// The watcher can only be used from the UI thread, once the event loop runs.
+			CallAfter( &FileDateCache::doWatchPending );
+		}
+
+		return result;
+	}
+
+	void FileDateCache::doWatchPending()
+	{
+		std::vector< wxString > folders;
+		{
+			std::lock_guard< std::mutex > lock{ m_mutex };
+			std::swap( folders, m_pendingFolders );
+		}
+
+		if ( m_polling )
+		{
+			return;
+		}
+
+		if ( !m_watcher )
+		{
+			m_watcher = std::make_unique< wxFileSystemWatcher >();
+			m_watcher->SetOwner( this );
+			Bind( wxEVT_FSWATCHER
+				, &FileDateCache::onFileSystemEvent
+				, this );
+		}
+
+		for ( auto & folder : folders )
+		{
+			if ( !doWatch( folder ) )
+			{
+				wxLogWarning( wxString{} << "Couldn't watch folder " << folder << ", polling the files dates instead." );
+				doStartPolling();
+				return;
+			}
+		}
+	}
+
+	bool FileDateCache::doWatch( wxString const & folder )
+	{
+		// The creation of a missing folder is only seen from its nearest existing parent.
+		auto watched = wxFileName::DirName( folder );
+
+		while ( !watched.DirExists()
+			&& watched.GetDirCount() > 0u )
+		{
+			watched.RemoveLastDir();
+		}
+
+		if ( !watched.DirExists() )
+		{
+			return true;
+		}
+
+		if ( watched.GetPath() != folder )
+		{
+			m_missingFolders.insert( folder );
+		}
+
+		return !m_watched.insert( watched.GetPath() ).second
+			|| m_watcher->Add( watched, filedt::WatchFlags );
+	}
+
+	void FileDateCache::doWatchCreated( wxString const & path )
+	{
+		std::vector< wxString > created;
+
+		for ( auto it = m_missingFolders.begin(); it != m_missingFolders.end(); )
+		{
+			if ( filedt::isInFolder( *it, path ) )
+			{
+				created.push_back( *it );
+				it = m_missingFolders.erase( it );
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		if ( created.empty() )
+		{
+			return;
+		}
+
+		for ( auto & folder : created )
+		{
+			if ( !doWatch( folder ) )
+			{
+				wxLogWarning( wxString{} << "Couldn't watch folder " << folder << ", polling the files dates instead." );
+				doStartPolling();
+				return;
+			}
+		}
+
+		// The files may have been created along with their folder, before it was watched.
+		std::vector< wxString > paths;
+
+		for ( auto & file : doListPaths() )
+		{
+			if ( filedt::isInFolder( file, path ) )
+			{
+				paths.push_back( file );
+			}
+		}
+
+		doNotify( doRefresh( paths ) );
+	}
+
+	void FileDateCache::doStartPolling()
+	{
+		if ( m_polling )
+		{
+			return;
+		}
+
+		m_polling = true;
+		m_watcher.reset();
+		m_watched.clear();
+		m_missingFolders.clear();
+		// The files dates are checked away from the UI thread, only the changes come back to it.
+		// The first check catches the changes missed before the watcher failed.
+		m_poller = std::thread{ [this]()
+			{
+				doPoll();
+			} };
+	}
+
+	void FileDateCache::doPoll()
+	{
+		auto lock = std::unique_lock< std::mutex >( m_mutex );
+
+		while ( !m_stopped )
+		{
+			lock.unlock();
+			auto changed = doRefresh( doListPaths() );
+
+			if ( !changed.empty() )
+			{
+				CallAfter( [this, changed]()
+					{
+						doNotify( changed );
+					} );
+			}
+
+			lock.lock();
+			m_pollCondition.wait_for( lock
+				, filedt::PollPeriod
+				, [this]()
+				{
+					return m_stopped;
+				} );
+		}
+	}
+
+	std::vector< wxString > FileDateCache::doListPaths()
+	{
+		std::vector< wxString > result;
+		std::lock_guard< std::mutex > lock{ m_mutex };
+		result.reserve( m_dates.size() );
+
+		for ( auto & date : m_dates )
+		{
+			result.push_back( date.first );
+		}
+
+		return result;
+	}
+
+	std::vector< wxString > FileDateCache::doRefresh( std::vector< wxString > const & paths )
+	{
+		std::vector< wxString > result;
+
+		for ( auto & path : paths )
+		{
+			// A removed file keeps its last date, getFileDate would give a new date at each refresh.
+			if ( !wxFileName::FileExists( path ) )
+			{
+				continue;
+			}
+
+			auto date = getFileDate( wxFileName{ path } );
+			std::lock_guard< std::mutex > lock{ m_mutex };
+			auto it = m_dates.find( path );
+
+			if ( it != m_dates.end()
+				&& it->second != date )
+			{
+				it->second = date;
+				result.push_back( path );
+			}
+		}
+
+		return result;
+	}
+
+	void FileDateCache::doNotify( std::vector< wxString > const & paths )
+	{
+		if ( !m_onChange )
+		{
+			return;
+		}
+
+		for ( auto & path : paths )
+		{
+			m_onChange( wxFileName{ path } );
+		}
+	}
+
+	void FileDateCache::onFileSystemEvent( wxFileSystemWatcherEvent & evt )
+	{
+		switch ( evt.GetChangeType() )
+		{
+		case wxFSW_EVENT_CREATE:
+			doWatchCreated( filedt::getKey( evt.GetPath() ) );
+			doNotify( doRefresh( { filedt::getKey( evt.GetPath() ) } ) );
+			break;
+		case wxFSW_EVENT_MODIFY:
+			doNotify( doRefresh( { filedt::getKey( evt.GetPath() ) } ) );
+			break;
+		case wxFSW_EVENT_RENAME:
+			// Editors often save through a temporary file, renamed over the original one.
+			doWatchCreated( filedt::getKey( evt.GetNewPath() ) );
+			doNotify( doRefresh( { filedt::getKey( evt.GetNewPath() ) } ) );
+			break;
+		case wxFSW_EVENT_WARNING:
+			// Some events may have been lost (queue overflow).
+			doNotify( doRefresh( doListPaths() ) );
+			break;
+		case wxFSW_EVENT_ERROR:
+			wxLogWarning( wxString{} << "File system watcher error: " << evt.GetErrorDescription() );
+			CallAfter( &FileDateCache::doStartPolling );
+			break;
+		default:
+			break;
+		}
+	}
+
+	//*********************************************************************************************
+}
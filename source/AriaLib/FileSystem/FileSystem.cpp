@@ -328,29 +328,13 @@ namespace aria
 		return result;
 	}
 
-	void FileSystem::touchDb( wxFileName const & file )
+	void FileSystem::touchDb()
 	{
-		if ( m_touchedDb )
-		{
-			for ( auto & plugin : m_plugins )
-			{
-				plugin->addFileMod( "Database", file );
-			}
-		}
-		else
-		{
-			for ( auto & plugin : m_plugins )
-			{
-				plugin->updateFile( "Database", file );
-			}
-
-			m_touchedDb = true;
-		}
+		m_touchedDb = true;
 	}
 
 	bool FileSystem::commit( wxString const & label )
 	{
-		m_touchedDb = false;
 		auto result = true;
 
 		for ( auto & plugin : m_plugins )
@@ -364,6 +348,24 @@ namespace aria
 		return result;
 	}
 
+	std::optional< wxFileName > FileSystem::prepareDbCommit()
+	{
+		if ( !m_onDbCommit
+			|| !m_touchedDb.exchange( false ) )
+		{
+			return std::nullopt;
+		}
+
+		if ( !m_onDbCommit() )
+		{
+			// It will be added to a later commit.
+			m_touchedDb = true;
+			return std::nullopt;
+		}
+
+		return m_database;
+	}
+
 	void FileSystem::doRegisterPlugin( FileSystemPluginPtr plugin )
 	{
 		m_plugins.emplace_back( std::move( plugin ) );
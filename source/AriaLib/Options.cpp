@@ -12,7 +12,14 @@ namespace aria
 	namespace option
 	{
 		static const wxString FrameCount{ wxT( "frames" ) };
+		static const wxString ConcurrentRuns{ wxT( "concurrent_runs" ) };
+		static const wxString DiffWorkers{ wxT( "diff_workers" ) };
 		static const wxString Database{ wxT( "database" ) };
+		static const wxString DatabaseJournalMode{ wxT( "database_journal_mode" ) };
+		static const wxString DatabaseSynchronous{ wxT( "database_synchronous" ) };
+		static const wxString DatabaseMmapSize{ wxT( "database_mmap_size" ) };
+		static const wxString DatabaseCacheSize{ wxT( "database_cache_size" ) };
+		static const wxString DatabaseTempStore{ wxT( "database_temp_store" ) };
 		static const wxString Test{ wxT( "test" ) };
 		static const wxString Work{ wxT( "work" ) };
 		static const wxString Plugin{ wxT( "plugin" ) };
@@ -58,6 +65,62 @@ namespace aria
 			}
 		}
 
+		static db::JournalMode getJournalMode( wxString const & name )
+		{
+			return name.IsSameAs( wxT( "delete" ), false )
+				? db::JournalMode::eDelete
+				: db::JournalMode::eWal;
+		}
+
+		static db::Synchronous getSynchronous( wxString const & name )
+		{
+			if ( name.IsSameAs( wxT( "off" ), false ) )
+			{
+				return db::Synchronous::eOff;
+			}
+
+			if ( name.IsSameAs( wxT( "full" ), false ) )
+			{
+				return db::Synchronous::eFull;
+			}
+
+			return db::Synchronous::eNormal;
+		}
+
+		static db::TempStore getTempStore( wxString const & name )
+		{
+			if ( name.IsSameAs( wxT( "default" ), false ) )
+			{
+				return db::TempStore::eDefault;
+			}
+
+			if ( name.IsSameAs( wxT( "file" ), false ) )
+			{
+				return db::TempStore::eFile;
+			}
+
+			return db::TempStore::eMemory;
+		}
+
+		static wxString getName( db::JournalMode value )
+		{
+			return value == db::JournalMode::eDelete
+				? wxT( "delete" )
+				: wxT( "wal" );
+		}
+
+		static wxString getName( db::Synchronous value )
+		{
+			static wxString const names[]{ wxT( "off" ), wxT( "normal" ), wxT( "full" ) };
+			return names[size_t( value )];
+		}
+
+		static wxString getName( db::TempStore value )
+		{
+			static wxString const names[]{ wxT( "default" ), wxT( "file" ), wxT( "memory" ) };
+			return names[size_t( value )];
+		}
+
 		wxString selectPlugin( PluginFactory const & factory )
 		{
 			wxArrayString choices;
@@ -152,7 +215,15 @@ namespace aria
 		pluginPtr->config.test = getFileName( option::Test, true );
 		pluginPtr->config.work = getFileName( option::Work, false, pluginPtr->config.test );
 		pluginPtr->config.maxFrameCount = getLong( option::FrameCount, false, option::df::FrameCount );
+		pluginPtr->config.maxConcurrentRuns = std::max( 1u, getLong( option::ConcurrentRuns, false, option::df::ConcurrentRuns ) );
+		pluginPtr->config.diffWorkers = std::max( 1u, getLong( option::DiffWorkers, false, pluginPtr->config.diffWorkers ) );
 		pluginPtr->config.database = getFileName( option::Database, false, pluginPtr->config.work / wxT( "db.sqlite" ) );
+		auto & dbOptions = pluginPtr->config.databaseOptions;
+		dbOptions.journalMode = option::getJournalMode( getString( option::DatabaseJournalMode, false, option::df::JournalMode ) );
+		dbOptions.synchronous = option::getSynchronous( getString( option::DatabaseSynchronous, false, option::df::Synchronous ) );
+		dbOptions.mmapSize = getLong( option::DatabaseMmapSize, false, option::df::MmapSize );
+		dbOptions.cacheSize = getLong( option::DatabaseCacheSize, false, option::df::CacheSize );
+		dbOptions.tempStore = option::getTempStore( getString( option::DatabaseTempStore, false, option::df::TempStore ) );
 		pluginPtr->config.plugin = pluginPtr->getName();
 		pluginPtr->config.pluginConfig->setup( *this );
 	}
@@ -258,7 +329,15 @@ namespace aria
 		configFile.Write( option::Test, pluginPtr->config.test.GetFullPath() );
 		configFile.Write( option::Work, pluginPtr->config.work.GetFullPath() );
 		configFile.Write( option::Database, pluginPtr->config.database.GetFullPath() );
+		auto & dbOptions = pluginPtr->config.databaseOptions;
+		configFile.Write( option::DatabaseJournalMode, option::getName( dbOptions.journalMode ) );
+		configFile.Write( option::DatabaseSynchronous, option::getName( dbOptions.synchronous ) );
+		configFile.Write( option::DatabaseMmapSize, wxString() << dbOptions.mmapSize );
+		configFile.Write( option::DatabaseCacheSize, wxString() << dbOptions.cacheSize );
+		configFile.Write( option::DatabaseTempStore, option::getName( dbOptions.tempStore ) );
 		configFile.Write( option::FrameCount, pluginPtr->config.maxFrameCount );
+		configFile.Write( option::ConcurrentRuns, pluginPtr->config.maxConcurrentRuns );
+		configFile.Write( option::DiffWorkers, pluginPtr->config.diffWorkers );
 		configFile.Write( option::Plugin, pluginPtr->config.plugin );
 		pluginPtr->config.pluginConfig->write( configFile );
 		configFile.Flush();
@@ -270,7 +349,8 @@ namespace aria
 	Options::Options( PluginFactory & factory
 		, std::vector< PluginLib > & pluginsLibs
 		, int argc
-		, wxCmdLineArgsArray const & argv )
+		, wxCmdLineArgsArray const & argv
+		, std::function< void( wxCmdLineParser & ) > const & fillParser )
 		: m_factory{ factory }
 		, parser{ argc, argv }
 		, configFile{ wxT( "Aria" )
@@ -294,13 +374,24 @@ namespace aria
 			, ConfigFile
 			, wxCMD_LINE_VAL_STRING, 0 );
 
-		if ( ( parser.Parse( false ) != 0 )
-			|| parser.Found( wxT( 'h' ) ) )
+		if ( fillParser )
+		{
+			fillParser( parser );
+		}
+
+		if ( parser.Parse( false ) != 0 )
 		{
 			parser.Usage();
 			throw false;
 		}
 
+		if ( parser.Found( wxT( 'h' ) ) )
+		{
+			parser.Usage();
+			// Not a failure, unlike the parsing errors.
+			throw true;
+		}
+
 		option::listPlugins( pluginsLibs, m_factory );
 		wxString entry;
 		long index;
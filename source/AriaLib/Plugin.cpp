@@ -8,6 +8,7 @@
 #include <wx/filectrl.h>
 #include <wx/stattext.h>
 #include <wx/sizer.h>
+#include <wx/spinctrl.h>
 #include <wx/tooltip.h>
 #include "AriaLib/EndExternHeaderGuard.hpp"
 
@@ -172,6 +173,42 @@ namespace aria
 			, topBorder );
 	}
 
+	void addUIntField( wxWindow & parent
+		, wxSizer & parentSizer
+		, wxString const & name
+		, wxString const & tip
+		, uint32_t & value
+		, uint32_t minValue
+		, uint32_t maxValue
+		, int topBorder )
+	{
+		auto fieldSizer = new wxBoxSizer( wxVERTICAL );
+		auto label = new wxStaticText{ &parent, wxID_ANY, name };
+		fieldSizer->Add( label, wxSizerFlags{} );
+
+		auto tooltip = new wxToolTip{ tip };
+		label->SetToolTip( tooltip );
+
+		auto picker = new wxSpinCtrl{ &parent
+			, wxID_ANY
+			, wxEmptyString
+			, wxDefaultPosition
+			, wxDefaultSize
+			, wxSP_ARROW_KEYS
+			, int( minValue )
+			, int( maxValue )
+			, int( value ) };
+		picker->SetMinSize( wxSize( config::MinWidth / 4, config::MinHeight ) );
+		fieldSizer->Add( picker, wxSizerFlags{}.FixedMinSize() );
+		picker->Bind( wxEVT_SPINCTRL
+			, [&value]( wxSpinEvent const & event )
+			{
+				value = uint32_t( std::max( 0, event.GetPosition() ) );
+			} );
+
+		parentSizer.Add( fieldSizer, wxSizerFlags{}.Border( wxUP, topBorder ) );
+	}
+
 	//*********************************************************************************************
 
 	void PluginFactory::registerPlugin( std::string name
@@ -7,8 +7,10 @@ namespace aria
 {
 	//*********************************************************************************************
 
-	TestsCounts::TestsCounts( Plugin const & plugin )
+	TestsCounts::TestsCounts( Plugin const & plugin
+		, TestsCounts * parent )
 		: m_plugin{ plugin }
+		, m_parent{ parent }
 	{
 	}
 
@@ -54,11 +56,17 @@ namespace aria
 		remove( getType( status ), 1u );
 	}
 
+	void TestsCounts::add( TestStatus status
+		, uint32_t count )
+	{
+		add( getType( status ), count );
+	}
+
 	void TestsCounts::add( TestsCounts const & counts )
 	{
 		for ( uint32_t i = 0u; i < uint32_t( TestsCountsType::eCount ); ++i )
 		{
-			m_values[i] += counts.m_values[i];
+			doAddValue( TestsCountsType( i ), counts.m_values[i] );
 		}
 	}
 
@@ -66,7 +74,7 @@ namespace aria
 	{
 		for ( uint32_t i = 0u; i < uint32_t( TestsCountsType::eCount ); ++i )
 		{
-			m_values[i] -= counts.m_values[i];
+			doRemoveValue( TestsCountsType( i ), counts.m_values[i] );
 		}
 	}
 
@@ -74,13 +82,38 @@ namespace aria
 	{
 		for ( uint32_t i = 0u; i < uint32_t( TestsCountsType::eCount ); ++i )
 		{
-			m_values[i] = CountedUInt{};
+			doRemoveValue( TestsCountsType( i ), m_values[i] );
 		}
 	}
 
-	CountedUInt & TestsCounts::getCount( TestsCountsType type )
+	void TestsCounts::addIgnored()
 	{
-		return m_values[type];
+		doAddValue( TestsCountsType::eIgnored, 1u );
+	}
+
+	void TestsCounts::removeIgnored()
+	{
+		doRemoveValue( TestsCountsType::eIgnored, 1u );
+	}
+
+	void TestsCounts::addOutdated()
+	{
+		doAddValue( TestsCountsType::eOutdated, 1u );
+	}
+
+	void TestsCounts::addOutdated( uint32_t count )
+	{
+		doAddValue( TestsCountsType::eOutdated, count );
+	}
+
+	void TestsCounts::removeOutdated()
+	{
+		doRemoveValue( TestsCountsType::eOutdated, 1u );
+	}
+
+	void TestsCounts::removeOutdated( uint32_t count )
+	{
+		doRemoveValue( TestsCountsType::eOutdated, count );
 	}
 
 	CountedUInt const & TestsCounts::getCount( TestsCountsType type )const
@@ -90,14 +123,7 @@ namespace aria
 
 	uint32_t TestsCounts::getValue( TestsCountsType type )const
 	{
-		if ( type == TestsCountsType::eNotRun )
-		{
-			auto iall = getAllValue();
-			auto allRun = getAllRunStatus();
-			assert( getAllValue() >= allRun );
-			return iall - allRun;
-		}
-
+		// The not run tests are counted like the other statuses, and in eAll.
 		return uint32_t( getCount( type ) );
 	}
 
@@ -123,41 +149,65 @@ namespace aria
 
 	uint32_t TestsCounts::getAllRunStatus()const
 	{
-		uint32_t result{};
-
-		for ( auto i = 1u; i < TestsCountsType::eCountedInAllEnd; ++i )
-		{
-			result += getValue( TestsCountsType( i ) );
-		}
-
-		return result;
+		assert( getAllValue() >= getNotRunValue() );
+		return getAllValue() - getNotRunValue();
 	}
 
 	void TestsCounts::add( TestsCountsType type
 		, uint32_t count )
 	{
-		getCount( TestsCountsType::eAll ) += count;
-		getCount( type ) += count;
+		doAddValue( TestsCountsType::eAll, count );
+		doAddValue( type, count );
 	}
 
 	void TestsCounts::remove( TestsCountsType type
 		, uint32_t count )
 	{
-		getCount( type ) -= count;
-		getCount( TestsCountsType::eAll ) -= count;
+		doRemoveValue( type, count );
+		doRemoveValue( TestsCountsType::eAll, count );
+	}
+
+	void TestsCounts::doAddValue( TestsCountsType type
+		, uint32_t count )
+	{
+		if ( !count )
+		{
+			return;
+		}
+
+		for ( auto counts = this; counts; counts = counts->m_parent )
+		{
+			counts->m_values[type] += count;
+		}
+	}
+
+	void TestsCounts::doRemoveValue( TestsCountsType type
+		, uint32_t count )
+	{
+		if ( !count )
+		{
+			return;
+		}
+
+		for ( auto counts = this; counts; counts = counts->m_parent )
+		{
+			counts->m_values[type] -= count;
+		}
 	}
 
 	//*********************************************************************************************
 
-	RendererTestsCounts::RendererTestsCounts( Plugin const & plugin )
+	RendererTestsCounts::RendererTestsCounts( Plugin const & plugin
+		, TestsCounts * parent )
 		: plugin{ plugin }
+		, totals{ plugin, parent }
 	{
 	}
 
 	TestsCounts & RendererTestsCounts::addCategory( Category category
 		, TestArray const & tests )
 	{
-		auto countsIt = categories.emplace( category, TestsCounts{ plugin } ).first;
+		auto countsIt = categories.try_emplace( category, plugin, &totals ).first;
 		return countsIt->second;
 	}
 
@@ -167,40 +217,17 @@ namespace aria
 		return countsIt->second;
 	}
 
-	uint32_t RendererTestsCounts::getValue( TestsCountsType type )const
-	{
-		uint32_t result{};
-
-		for ( auto & category : categories )
-		{
-			result += category.second.getValue( type );
-		}
-
-		return result;
-	}
-
-	uint32_t RendererTestsCounts::getAllValue()const
-	{
-		uint32_t result{};
-
-		for ( auto & category : categories )
-		{
-			result += category.second.getAllValue();
-		}
-
-		return result;
-	}
-
 	//*********************************************************************************************
 
 	AllTestsCounts::AllTestsCounts( Plugin const & plugin )
 		: plugin{ plugin }
+		, totals{ plugin }
 	{
 	}
 
 	RendererTestsCounts & AllTestsCounts::addRenderer( Renderer renderer )
 	{
-		auto countsIt = renderers.emplace( renderer, RendererTestsCounts{ plugin } ).first;
+		auto countsIt = renderers.try_emplace( renderer, plugin, &totals ).first;
 		return countsIt->second;
 	}
 
@@ -223,29 +250,5 @@ namespace aria
 		return getRenderer( renderer ).getCounts( category );
 	}
 
-	uint32_t AllTestsCounts::getValue( TestsCountsType type )const
-	{
-		uint32_t result{};
-
-		for ( auto & renderer : renderers )
-		{
-			result += renderer.second.getValue( type );
-		}
-
-		return result;
-	}
-
-	uint32_t AllTestsCounts::getAllValue()const
-	{
-		uint32_t result{};
-
-		for ( auto & renderer : renderers )
-		{
-			result += renderer.second.getAllValue();
-		}
-
-		return result;
-	}
-
 	//*********************************************************************************************
 }
@@ -348,13 +348,13 @@ namespace aria::c3d
 	{
 		auto & pluginConfig = static_cast< C3dPluginConfig & >( *m_pluginConfig );
 		return ( !test.engineDate.IsValid() )
-			|| test.engineDate.IsEarlierThan( getFileDate( pluginConfig.engine ) );
+			|| test.engineDate.IsEarlierThan( fileDates.get( pluginConfig.engine ) );
 	}
 
 	bool C3dPlugin::isOutOfTestDate( TestRun const & test )const
 	{
 		return ( !test.testDate.IsValid() )
-			|| test.testDate.IsEarlierThan( getTestDate( *test.test ) );
+			|| test.testDate.IsEarlierThan( fileDates.get( getTestFileName( *test.test ) ) );
 	}
 
 	bool C3dPlugin::isSceneFile( wxString const & test )const